@@ -0,0 +1,88 @@
+#pragma once
+
+#include <psql/detail/serialization.hpp>
+#include <psql/result.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+namespace bench
+{
+template<typename T>
+void do_not_optimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class runner
+{
+  std::string_view filter_;
+
+public:
+  explicit runner(std::string_view filter)
+    : filter_{ filter }
+  {
+  }
+
+  // Runs `f` repeatedly and reports the fastest of several samples, each one long enough to hide the clock overhead.
+  template<typename F>
+  void run(std::string_view name, F&& f)
+  {
+    using clock = std::chrono::steady_clock;
+
+    if (name.find(filter_) == std::string_view::npos)
+      return;
+
+    auto measure = [&](std::size_t iterations)
+    {
+      const auto start = clock::now();
+      for (std::size_t i = 0; i < iterations; i++)
+        f();
+      return clock::now() - start;
+    };
+
+    auto iterations = std::size_t{ 1 };
+    while (measure(iterations) < std::chrono::milliseconds{ 20 } && iterations < (std::size_t{ 1 } << 30))
+      iterations *= 2;
+
+    auto best = clock::duration::max();
+    for (auto i = 0; i < 5; i++)
+      best = std::min(best, measure(iterations));
+
+    const auto ns = std::chrono::duration<double, std::nano>{ best }.count() / iterations;
+    std::cout << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed
+              << std::setprecision(1) << ns << " ns/op" << std::endl;
+  }
+};
+
+// Builds a binary-format result with one column per value and `rows` identical rows, the way the server would send it.
+template<typename... Ts>
+psql::result make_result(const psql::detail::oid_map& omp, int rows, const Ts&... values)
+{
+  auto* pgresult = PQmakeEmptyPGresult(nullptr, PGRES_TUPLES_OK);
+
+  PGresAttDesc attrs[] = { { const_cast<char*>("column"), 0, 0, 1, psql::detail::oid_of<Ts>(omp), -1, -1 }... };
+  PQsetResultAttrs(pgresult, sizeof...(Ts), attrs);
+
+  std::string buffers[] = { [&]
+                            {
+                              auto buffer = std::string{};
+                              buffer.reserve(psql::detail::size_of(values));
+                              psql::detail::serialize(omp, buffer, values);
+                              return buffer;
+                            }()... };
+
+  for (auto row = 0; row < rows; row++)
+    for (auto col = 0; col < static_cast<int>(sizeof...(Ts)); col++)
+      PQsetvalue(pgresult, row, col, buffers[col].data(), buffers[col].size());
+
+  return psql::result{ pgresult };
+}
+
+void serialization(runner& r);
+void deserialization(runner& r);
+void oid_lookup(runner& r);
+} // namespace bench
@@ -0,0 +1,175 @@
+#include "benchmark.hpp"
+#include "types.hpp"
+
+#include <memory_resource>
+
+namespace bench
+{
+namespace
+{
+template<typename T, typename Decoded = T, typename Mode = psql::hardened_t>
+void run_deserialize(
+  runner& r,
+  std::string_view name,
+  const psql::detail::oid_map& omp,
+  const T& value,
+  Mode mode = Mode{})
+{
+  auto buffer = std::string{};
+  psql::detail::serialize(omp, buffer, value);
+  r.run(
+    name,
+    [&]
+    {
+      auto decoded = Decoded{};
+      psql::detail::deserialize(buffer, decoded, mode);
+      do_not_optimize(decoded);
+    });
+}
+
+template<typename T>
+void run_as_field(runner& r, std::string_view name, const psql::detail::oid_map& omp, const T& value)
+{
+  const auto result = make_result(omp, 1, value);
+  r.run(name, [&] { do_not_optimize(as<T>(result[0][0])); });
+}
+} // namespace
+
+void deserialization(runner& r)
+{
+  const auto omp = make_oid_map();
+
+  run_deserialize(r, "deserialize/int64", omp, int64_t{ 42 });
+  run_deserialize(r, "deserialize/time_point", omp, std::chrono::system_clock::now());
+  run_deserialize(r, "deserialize/date", omp, std::chrono::sys_days{ std::chrono::year{ 2024 } / 2 / 29 });
+  run_deserialize(r, "deserialize/uuid", omp, psql::uuid{});
+  run_deserialize(r, "deserialize/decimal_64", omp, psql::decimal{ 123456789012345, 2 });
+  run_deserialize(
+    r, "deserialize/decimal_128", omp, psql::decimal{ psql::int128_t{ 123456789012345 } * 1000000000000000, 2 });
+  run_deserialize<psql::decimal, psql::numeric_text<>>(
+    r, "deserialize/numeric_text_128", omp, psql::decimal{ psql::int128_t{ 123456789012345 } * 1000000000000000, 2 });
+  run_deserialize(r, "deserialize/string_16", omp, std::string(16, 'x'));
+  run_deserialize(r, "deserialize/string_4096", omp, std::string(4096, 'x'));
+  run_deserialize(r, "deserialize/array_int32_10000", omp, std::vector<int32_t>(10000, 7));
+  const auto matrix = std::vector<std::vector<double>>(100, std::vector<double>(100, 0.5));
+  run_deserialize(r, "deserialize/matrix_double_100x100", omp, matrix);
+  run_deserialize<std::vector<std::vector<double>>, psql::md_array<double>>(
+    r, "deserialize/md_array_double_100x100", omp, matrix);
+  run_deserialize(r, "deserialize/array_string_1000", omp, std::vector<std::string>(1000, std::string(16, 'x')));
+  run_deserialize<std::vector<std::string>, std::vector<std::string_view>>(
+    r, "deserialize/array_string_view_1000", omp, std::vector<std::string>(1000, std::string(16, 'x')));
+  run_deserialize(r, "deserialize/bytea_65536", omp, std::vector<std::byte>(65536, std::byte{ 7 }));
+  run_deserialize<std::vector<std::byte>, std::span<const std::byte>>(
+    r, "deserialize/bytea_view_65536", omp, std::vector<std::byte>(65536, std::byte{ 7 }));
+  run_deserialize<psql::jsonb<std::string>, psql::jsonb<std::string>>(
+    r, "deserialize/jsonb_string_4096", omp, psql::jsonb{ std::string(4096, 'x') });
+  run_deserialize<psql::jsonb<std::string>, psql::jsonb<>>(
+    r, "deserialize/jsonb_view_4096", omp, psql::jsonb{ std::string(4096, 'x') });
+  run_deserialize(r, "deserialize/enum", omp, status::suspended);
+  run_deserialize(r, "deserialize/composite", omp, make_employee(1));
+  run_deserialize(r, "deserialize/nested_composite_16", omp, make_company(16));
+  run_deserialize(r, "deserialize/array_composite_1000", omp, make_company(1000).employees);
+
+  // The same payloads decoded without verifications.
+  run_deserialize(r, "deserialize_trusted/int64", omp, int64_t{ 42 }, psql::trusted);
+  run_deserialize(r, "deserialize_trusted/array_int32_10000", omp, std::vector<int32_t>(10000, 7), psql::trusted);
+  run_deserialize<std::vector<std::string>, std::vector<std::string_view>>(
+    r,
+    "deserialize_trusted/array_string_view_1000",
+    omp,
+    std::vector<std::string>(1000, std::string(16, 'x')),
+    psql::trusted);
+  run_deserialize(r, "deserialize_trusted/composite", omp, make_employee(1), psql::trusted);
+  run_deserialize(r, "deserialize_trusted/nested_composite_16", omp, make_company(16), psql::trusted);
+  run_deserialize(r, "deserialize_trusted/array_composite_1000", omp, make_company(1000).employees, psql::trusted);
+
+  run_as_field(r, "as/field_int32", omp, int32_t{ 42 });
+  run_as_field(r, "as/field_string", omp, std::string(16, 'x'));
+  run_as_field(r, "as/field_nested_composite_16", omp, make_company(16));
+
+  {
+    const auto result = make_result(omp, 1, int32_t{ 1 }, int64_t{ 2 }, 3.0, std::string(16, 'x'));
+    r.run(
+      "as/row_4_columns",
+      [&] { do_not_optimize(as<int32_t, int64_t, double, std::string_view>(result[0])); });
+  }
+
+  {
+    const auto result = make_result(omp, 1000, int32_t{ 1 }, std::string(16, 'x'));
+    r.run(
+      "as/result_1000_rows",
+      [&]
+      {
+        for (const auto row : result)
+          do_not_optimize(as<int32_t, std::string_view>(row));
+      });
+  }
+
+  {
+    const auto result = make_result(omp, 1, std::vector<std::string>(1000, std::string(16, 'x')));
+    auto decoded      = std::vector<std::string>{};
+    r.run(
+      "decode_into/array_string_1000",
+      [&]
+      {
+        decode_into(result[0][0], decoded);
+        do_not_optimize(decoded);
+      });
+  }
+
+  {
+    auto buffer = std::string{};
+    psql::detail::serialize(omp, buffer, std::vector<std::string>(1000, std::string(16, 'x')));
+    auto storage = std::vector<std::byte>(64 * 1024);
+    r.run(
+      "deserialize_pmr/array_string_1000",
+      [&]
+      {
+        auto arena   = std::pmr::monotonic_buffer_resource{ storage.data(), storage.size() };
+        auto decoded = std::pmr::vector<std::pmr::string>{ &arena };
+        psql::detail::deserialize(buffer, decoded);
+        do_not_optimize(decoded);
+      });
+  }
+
+  {
+    const auto result = make_result(omp, 1000, int32_t{ 1 }, std::string(16, 'x'));
+    auto rows         = std::vector<std::tuple<int32_t, std::string>>{};
+    r.run(
+      "decode_into/result_1000_rows",
+      [&]
+      {
+        decode_into(result, rows);
+        do_not_optimize(rows);
+      });
+  }
+
+  {
+    const auto result = make_result(omp, 1, int32_t{ 1 }, int64_t{ 2 }, 3.0, std::string(16, 'x'));
+    r.run(
+      "try_as/row_4_columns",
+      [&] { do_not_optimize(try_as<int32_t, int64_t, double, std::string_view>(result[0])); });
+    r.run(
+      "try_as_trusted/row_4_columns",
+      [&] { do_not_optimize(try_as<int32_t, int64_t, double, std::string_view>(result[0], psql::trusted)); });
+
+    // Decoding the int64 column as int32 fails with a mismatched OID.
+    r.run(
+      "as/row_mismatched_oid",
+      [&]
+      {
+        try
+        {
+          do_not_optimize(as<int32_t, int32_t, double, std::string_view>(result[0]));
+        }
+        catch (const std::exception& e)
+        {
+          do_not_optimize(e);
+        }
+      });
+    r.run(
+      "try_as/row_mismatched_oid",
+      [&] { do_not_optimize(try_as<int32_t, int32_t, double, std::string_view>(result[0])); });
+  }
+}
+} // namespace bench
@@ -0,0 +1,631 @@
+#pragma once
+
+#include <boost/asio/as_tuple.hpp>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/endian.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+namespace asio = boost::asio;
+
+// A stand-in for a PostgreSQL server that speaks enough of the v3 protocol to drive the client state machine
+// without a database: startup with trust authentication, simple and extended query protocols (including pipelines),
+// SQL PREPARE, NOTIFY and cancel requests.
+//
+// Responses are canned:
+// * `SELECT $1, $2::INT8, ...` echoes the bound parameters back as a single row.
+// * Any other SELECT returns `rows` text rows of `row_size` bytes.
+// * `NOTIFY channel[, 'payload']` sends a notification back to the same session.
+// * Queries starting with `ERROR` fail with a syntax error.
+// * Everything else completes with a command tag made of its first word.
+// Each query is delayed by `latency` before its response is sent; a cancel request interrupts the delay.
+class fake_server
+{
+public:
+  struct options
+  {
+    std::chrono::microseconds latency{};
+    std::size_t rows     = 1;
+    std::size_t row_size = 16;
+  };
+
+private:
+  using tcp = asio::ip::tcp;
+
+  struct statement
+  {
+    std::string query;
+    std::vector<uint32_t> param_types;
+  };
+
+  struct portal
+  {
+    statement stmt;
+    std::vector<std::optional<std::string>> params;
+    std::vector<int16_t> result_formats;
+  };
+
+  struct column
+  {
+    std::string name;
+    uint32_t type;
+  };
+
+  class reader
+  {
+    std::string_view body_;
+
+  public:
+    explicit reader(std::string_view body)
+      : body_{ body }
+    {
+    }
+
+    int16_t int16()
+    {
+      auto value = boost::endian::load_big_s16(reinterpret_cast<const unsigned char*>(body_.data()));
+      body_.remove_prefix(2);
+      return value;
+    }
+
+    int32_t int32()
+    {
+      auto value = boost::endian::load_big_s32(reinterpret_cast<const unsigned char*>(body_.data()));
+      body_.remove_prefix(4);
+      return value;
+    }
+
+    std::string_view bytes(std::size_t size)
+    {
+      auto value = body_.substr(0, size);
+      body_.remove_prefix(size);
+      return value;
+    }
+
+    std::string_view cstring()
+    {
+      auto value = body_.substr(0, body_.find('\0'));
+      body_.remove_prefix(value.size() + 1);
+      return value;
+    }
+  };
+
+  class writer
+  {
+    std::string& out_;
+    std::size_t start_;
+
+  public:
+    writer(std::string& out, char type)
+      : out_{ out }
+      , start_{ out.size() + 1 }
+    {
+      out_.push_back(type);
+      int32(0);
+    }
+
+    writer(const writer&) = delete;
+
+    ~writer()
+    {
+      boost::endian::store_big_s32(
+        reinterpret_cast<unsigned char*>(out_.data() + start_), static_cast<int32_t>(out_.size() - start_));
+    }
+
+    writer& int16(int16_t value)
+    {
+      out_.resize(out_.size() + 2);
+      boost::endian::store_big_s16(reinterpret_cast<unsigned char*>(out_.data() + out_.size() - 2), value);
+      return *this;
+    }
+
+    writer& int32(int32_t value)
+    {
+      out_.resize(out_.size() + 4);
+      boost::endian::store_big_s32(reinterpret_cast<unsigned char*>(out_.data() + out_.size() - 4), value);
+      return *this;
+    }
+
+    writer& bytes(std::string_view value)
+    {
+      out_.append(value);
+      return *this;
+    }
+
+    writer& cstring(std::string_view value)
+    {
+      out_.append(value).push_back('\0');
+      return *this;
+    }
+  };
+
+  struct session
+  {
+    tcp::socket socket;
+    asio::steady_timer timer;
+    int32_t pid;
+    int32_t secret;
+    std::string out;
+    std::map<std::string, statement, std::less<>> statements;
+    std::map<std::string, portal, std::less<>> portals;
+    bool executing = false;
+    bool canceled  = false;
+
+    session(tcp::socket socket, int32_t pid)
+      : socket{ std::move(socket) }
+      , timer{ this->socket.get_executor() }
+      , pid{ pid }
+      , secret{ pid * 7919 }
+    {
+    }
+  };
+
+  tcp::acceptor acceptor_;
+  options opts_;
+  int32_t next_pid_ = 1000;
+  std::map<int32_t, session*> sessions_;
+
+public:
+  fake_server(asio::any_io_executor exec, options opts)
+    : acceptor_{ exec, tcp::endpoint{ asio::ip::address_v4::loopback(), 0 } }
+    , opts_{ opts }
+  {
+  }
+
+  unsigned short port() const
+  {
+    return acceptor_.local_endpoint().port();
+  }
+
+  std::string conninfo() const
+  {
+    return "host=127.0.0.1 port=" + std::to_string(port()) + " user=bench dbname=bench sslmode=disable";
+  }
+
+  void start()
+  {
+    asio::co_spawn(acceptor_.get_executor(), accept_loop(), asio::detached);
+  }
+
+  void stop()
+  {
+    acceptor_.close();
+    for (auto& [_, s] : sessions_)
+    {
+      s->timer.cancel();
+      s->socket.close();
+    }
+  }
+
+private:
+  asio::awaitable<void> accept_loop()
+  {
+    for (;;)
+    {
+      auto [ec, socket] = co_await acceptor_.async_accept(asio::as_tuple(asio::deferred));
+      if (ec)
+        co_return;
+
+      socket.set_option(tcp::no_delay{ true });
+      asio::co_spawn(acceptor_.get_executor(), run_session(std::move(socket)), asio::detached);
+    }
+  }
+
+  static asio::awaitable<std::string> read_exactly(tcp::socket& socket, std::size_t size)
+  {
+    auto body = std::string(size, '\0');
+    co_await asio::async_read(socket, asio::buffer(body), asio::deferred);
+    co_return body;
+  }
+
+  asio::awaitable<void> run_session(tcp::socket socket)
+  {
+    auto s = session{ std::move(socket), next_pid_++ };
+
+    try
+    {
+      // The startup phase uses untyped messages, possibly preceded by SSL/GSS encryption requests.
+      for (;;)
+      {
+        auto header = co_await read_exactly(s.socket, 4);
+        auto body   = co_await read_exactly(s.socket, reader{ header }.int32() - 4);
+        auto r      = reader{ body };
+        auto code   = r.int32();
+
+        if (code == 80877103 || code == 80877104) // SSLRequest, GSSENCRequest
+        {
+          co_await asio::async_write(s.socket, asio::buffer("N", 1), asio::deferred);
+          continue;
+        }
+
+        if (code == 80877102) // CancelRequest
+        {
+          auto pid    = r.int32();
+          auto secret = r.int32();
+          if (auto it = sessions_.find(pid); it != sessions_.end() && it->second->secret == secret)
+            cancel(*it->second);
+          co_return;
+        }
+
+        break;
+      }
+
+      sessions_.emplace(s.pid, &s);
+
+      writer{ s.out, 'R' }.int32(0);
+      for (auto [name, value] : { std::pair{ "server_version", "16.0" },
+                                  std::pair{ "server_encoding", "UTF8" },
+                                  std::pair{ "client_encoding", "UTF8" },
+                                  std::pair{ "DateStyle", "ISO, MDY" },
+                                  std::pair{ "integer_datetimes", "on" },
+                                  std::pair{ "standard_conforming_strings", "on" },
+                                  std::pair{ "TimeZone", "UTC" } })
+        writer{ s.out, 'S' }.cstring(name).cstring(value);
+      writer{ s.out, 'K' }.int32(s.pid).int32(s.secret);
+      writer{ s.out, 'Z' }.bytes("I");
+      co_await flush(s);
+
+      co_await process_messages(s);
+    }
+    catch (const std::exception&)
+    {
+      // The client went away.
+    }
+
+    sessions_.erase(s.pid);
+  }
+
+  asio::awaitable<void> process_messages(session& s)
+  {
+    auto failed = false;
+
+    for (;;)
+    {
+      auto header = co_await read_exactly(s.socket, 5);
+      auto body   = co_await read_exactly(s.socket, reader{ std::string_view{ header }.substr(1) }.int32() - 4);
+      auto r      = reader{ body };
+
+      // After an error in the extended query protocol, messages are discarded until the next Sync.
+      if (failed && header[0] != 'S')
+        continue;
+
+      switch (header[0])
+      {
+        case 'Q':
+        {
+          auto p = portal{ statement{ std::string{ r.cstring() }, {} }, {}, {} };
+          if (p.stmt.query.empty())
+            writer{ s.out, 'I' };
+          else if (co_await execute(s, p, true))
+            register_prepare(s, p.stmt.query);
+          writer{ s.out, 'Z' }.bytes("I");
+          co_await flush(s);
+          break;
+        }
+        case 'P':
+        {
+          auto name  = std::string{ r.cstring() };
+          auto stmt  = statement{ std::string{ r.cstring() }, {} };
+          auto count = r.int16();
+          for (auto i = 0; i < count; i++)
+            stmt.param_types.push_back(r.int32());
+
+          if (!name.empty() && s.statements.contains(name))
+          {
+            error(s, "42P05", "prepared statement \"" + name + "\" already exists");
+            failed = true;
+            break;
+          }
+
+          s.statements[name] = std::move(stmt);
+          writer{ s.out, '1' };
+          break;
+        }
+        case 'B':
+        {
+          auto portal_name = std::string{ r.cstring() };
+          auto stmt_name   = r.cstring();
+          auto it          = s.statements.find(stmt_name);
+
+          if (it == s.statements.end())
+          {
+            error(s, "26000", "prepared statement \"" + std::string{ stmt_name } + "\" does not exist");
+            failed = true;
+            break;
+          }
+
+          auto p = portal{ it->second, {}, {} };
+          r.bytes(2 * r.int16()); // parameter formats
+          for (auto i = 0, count = int{ r.int16() }; i < count; i++)
+          {
+            auto size = r.int32();
+            p.params.push_back(size < 0 ? std::nullopt : std::optional{ std::string{ r.bytes(size) } });
+          }
+          for (auto i = 0, count = int{ r.int16() }; i < count; i++)
+            p.result_formats.push_back(r.int16());
+
+          s.portals[portal_name] = std::move(p);
+          writer{ s.out, '2' };
+          break;
+        }
+        case 'D':
+        {
+          auto kind = r.bytes(1);
+          auto name = r.cstring();
+
+          if (kind == "S")
+          {
+            auto it = s.statements.find(name);
+            if (it == s.statements.end())
+            {
+              error(s, "26000", "prepared statement \"" + std::string{ name } + "\" does not exist");
+              failed = true;
+              break;
+            }
+
+            {
+              auto w = writer{ s.out, 't' };
+              w.int16(it->second.param_types.size());
+              for (auto type : it->second.param_types)
+                w.int32(type);
+            }
+            describe(s, portal{ it->second, {}, {} }, false);
+            break;
+          }
+
+          auto it = s.portals.find(name);
+          if (it == s.portals.end())
+          {
+            error(s, "34000", "portal \"" + std::string{ name } + "\" does not exist");
+            failed = true;
+            break;
+          }
+
+          describe(s, it->second, false);
+          break;
+        }
+        case 'E':
+        {
+          auto it = s.portals.find(r.cstring());
+          if (it == s.portals.end())
+          {
+            error(s, "34000", "portal does not exist");
+            failed = true;
+            break;
+          }
+
+          failed = !co_await execute(s, it->second, false);
+          if (!failed)
+            register_prepare(s, it->second.stmt.query);
+          break;
+        }
+        case 'C':
+          writer{ s.out, '3' };
+          break;
+        case 'H':
+          co_await flush(s);
+          break;
+        case 'S':
+          failed = false;
+          s.portals.erase("");
+          writer{ s.out, 'Z' }.bytes("I");
+          co_await flush(s);
+          break;
+        case 'X':
+          co_return;
+        default:
+          error(s, "08P01", "unsupported message type");
+          co_await flush(s);
+          co_return;
+      }
+    }
+  }
+
+  static bool starts_with_word(std::string_view query, std::string_view word)
+  {
+    return query.size() >= word.size() && std::equal(
+                                             word.begin(),
+                                             word.end(),
+                                             query.begin(),
+                                             [](char a, char b) { return std::toupper(a) == std::toupper(b); });
+  }
+
+  // Matches `SELECT $1, $2::TYPE, ...`.
+  static bool is_echo_query(std::string_view query)
+  {
+    if (!starts_with_word(query, "SELECT "))
+      return false;
+
+    query.remove_prefix(7);
+    while (!query.empty() && query.back() == ';')
+      query.remove_suffix(1);
+
+    while (!query.empty())
+    {
+      auto token = query.substr(0, query.find(','));
+      query.remove_prefix(std::min(query.size(), token.size() + 1));
+      while (!token.empty() && token.front() == ' ')
+        token.remove_prefix(1);
+      token = token.substr(0, token.find("::"));
+      if (token.size() < 2 || token[0] != '$' || token.find_first_not_of("0123456789", 1) != std::string_view::npos)
+        return false;
+    }
+
+    return true;
+  }
+
+  std::vector<column> columns_of(const portal& p) const
+  {
+    if (is_echo_query(p.stmt.query))
+    {
+      auto columns = std::vector<column>{};
+      for (auto i = std::size_t{}; i < p.stmt.param_types.size() || i < p.params.size(); i++)
+      {
+        auto type = i < p.stmt.param_types.size() ? p.stmt.param_types[i] : 0;
+        columns.push_back({ "?column?", type ? type : 25 });
+      }
+      return columns;
+    }
+
+    if (starts_with_word(p.stmt.query, "SELECT"))
+      return { { "value", 25 } };
+
+    return {};
+  }
+
+  static int16_t result_format(const portal& p, std::size_t index)
+  {
+    if (p.result_formats.empty())
+      return 0;
+    return p.result_formats.size() == 1 ? p.result_formats[0] : p.result_formats.at(index);
+  }
+
+  void describe(session& s, const portal& p, bool text) const
+  {
+    auto columns = columns_of(p);
+
+    // The simple query protocol omits the description of queries that return no rows.
+    if (columns.empty())
+    {
+      if (!text)
+        writer{ s.out, 'n' };
+      return;
+    }
+
+    auto w = writer{ s.out, 'T' };
+    w.int16(columns.size());
+    for (auto i = std::size_t{}; i < columns.size(); i++)
+      w.cstring(columns[i].name).int32(0).int16(0).int32(columns[i].type).int16(-1).int32(-1).int16(
+        text ? 0 : result_format(p, i));
+  }
+
+  asio::awaitable<bool> execute(session& s, const portal& p, bool simple)
+  {
+    if (opts_.latency.count())
+    {
+      co_await flush(s);
+      s.executing = true;
+      s.timer.expires_after(opts_.latency);
+      co_await s.timer.async_wait(asio::as_tuple(asio::deferred));
+      s.executing = false;
+
+      if (std::exchange(s.canceled, false))
+      {
+        error(s, "57014", "canceling statement due to user request");
+        co_return false;
+      }
+    }
+
+    const auto& query = p.stmt.query;
+
+    if (starts_with_word(query, "ERROR"))
+    {
+      error(s, "42601", "syntax error at or near \"ERROR\"");
+      co_return false;
+    }
+
+    if (simple)
+      describe(s, p, true);
+
+    if (is_echo_query(query))
+    {
+      {
+        auto w = writer{ s.out, 'D' };
+        w.int16(p.params.size());
+        for (const auto& param : p.params)
+          param ? w.int32(param->size()).bytes(*param) : w.int32(-1);
+      }
+      writer{ s.out, 'C' }.cstring("SELECT 1");
+    }
+    else if (starts_with_word(query, "SELECT"))
+    {
+      const auto value = std::string(opts_.row_size, 'x');
+      for (auto i = std::size_t{}; i < opts_.rows; i++)
+        writer{ s.out, 'D' }.int16(1).int32(value.size()).bytes(value);
+      writer{ s.out, 'C' }.cstring("SELECT " + std::to_string(opts_.rows));
+    }
+    else if (starts_with_word(query, "NOTIFY "))
+    {
+      auto args    = std::string_view{ query }.substr(7);
+      auto channel = args.substr(0, args.find_first_of(",; "));
+      auto payload = std::string_view{};
+      if (auto first = args.find('\''), last = args.rfind('\''); first != last)
+        payload = args.substr(first + 1, last - first - 1);
+
+      writer{ s.out, 'C' }.cstring("NOTIFY");
+      writer{ s.out, 'A' }.int32(s.pid).cstring(channel).cstring(payload);
+    }
+    else
+    {
+      auto tag = std::string{ query.substr(0, query.find_first_of(" ;")) };
+      for (auto& c : tag)
+        c = std::toupper(c);
+      writer{ s.out, 'C' }.cstring(tag == "INSERT" ? "INSERT 0 1" : tag);
+    }
+
+    co_return true;
+  }
+
+  // Registers statements created with SQL `PREPARE name[(types)] AS query`.
+  static void register_prepare(session& s, std::string_view query)
+  {
+    if (!starts_with_word(query, "PREPARE "))
+      return;
+
+    query.remove_prefix(8);
+    auto name = query.substr(0, query.find_first_of("( "));
+    if (name.size() > 1 && name.front() == '"' && name.back() == '"')
+      name = name.substr(1, name.size() - 2);
+
+    auto as = query.find(" AS ");
+    if (as == std::string_view::npos)
+      return;
+
+    s.statements[std::string{ name }] = statement{ std::string{ query.substr(as + 4) }, {} };
+  }
+
+  static void error(session& s, std::string_view code, std::string_view message)
+  {
+    auto w = writer{ s.out, 'E' };
+    w.bytes("S").cstring("ERROR");
+    w.bytes("V").cstring("ERROR");
+    w.bytes("C").cstring(code);
+    w.bytes("M").cstring(message);
+    w.bytes({ "", 1 });
+  }
+
+  static void cancel(session& s)
+  {
+    if (s.executing)
+    {
+      s.canceled = true;
+      s.timer.cancel();
+    }
+  }
+
+  static asio::awaitable<void> flush(session& s)
+  {
+    if (s.out.empty())
+      co_return;
+
+    co_await asio::async_write(s.socket, asio::buffer(s.out), asio::deferred);
+    s.out.clear();
+  }
+};
+} // namespace bench
@@ -0,0 +1,11 @@
+#include "benchmark.hpp"
+
+int main(int argc, char** argv)
+{
+  // An optional argument filters benchmarks by a substring of their names.
+  auto runner = bench::runner{ argc > 1 ? argv[1] : "" };
+
+  bench::serialization(runner);
+  bench::deserialization(runner);
+  bench::oid_lookup(runner);
+}
@@ -0,0 +1,35 @@
+#include "benchmark.hpp"
+#include "types.hpp"
+
+#include <psql/detail/extract_new_udts.hpp>
+
+namespace bench
+{
+void oid_lookup(runner& r)
+{
+  const auto omp   = make_oid_map();
+  const auto empty = psql::detail::oid_map{};
+
+  r.run("oid_of/builtin", [&] { do_not_optimize(psql::detail::oid_of<int64_t>(omp)); });
+  r.run("oid_of/udt", [&] { do_not_optimize(psql::detail::oid_of<company>(omp)); });
+  r.run("oid_of/array_of_udt", [&] { do_not_optimize(psql::detail::oid_of<std::vector<employee>>(omp)); });
+
+  auto new_udts = std::vector<psql::detail::udt_pair>{};
+  r.run(
+    "extract_new_udts/known",
+    [&]
+    {
+      new_udts.clear();
+      psql::detail::extract_new_udts<company>(new_udts, omp);
+      do_not_optimize(new_udts);
+    });
+  r.run(
+    "extract_new_udts/unknown",
+    [&]
+    {
+      new_udts.clear();
+      psql::detail::extract_new_udts<company>(new_udts, empty);
+      do_not_optimize(new_udts);
+    });
+}
+} // namespace bench
@@ -0,0 +1,47 @@
+#include "benchmark.hpp"
+#include "types.hpp"
+
+namespace bench
+{
+namespace
+{
+template<typename... Ts>
+void run_serialize(runner& r, std::string_view name, const psql::detail::oid_map& omp, const Ts&... values)
+{
+  auto buffer = std::string{};
+  auto params = psql::mp(values...);
+  r.run(
+    name,
+    [&]
+    {
+      auto serialized = psql::detail::serialize(omp, buffer, params);
+      do_not_optimize(serialized);
+    });
+}
+} // namespace
+
+void serialization(runner& r)
+{
+  const auto omp = make_oid_map();
+
+  run_serialize(r, "serialize/int64", omp, int64_t{ 42 });
+  run_serialize(r, "serialize/scalars", omp, int16_t{ 1 }, int32_t{ 2 }, int64_t{ 3 }, 4.0, true);
+  run_serialize(r, "serialize/time_point", omp, std::chrono::system_clock::now());
+  run_serialize(r, "serialize/decimal_64", omp, psql::decimal{ 123456789012345, 2 });
+  run_serialize(
+    r, "serialize/decimal_128", omp, psql::decimal{ psql::int128_t{ 123456789012345 } * 1000000000000000, 2 });
+  run_serialize(r, "serialize/string_16", omp, std::string(16, 'x'));
+  run_serialize(r, "serialize/string_4096", omp, std::string(4096, 'x'));
+  run_serialize(r, "serialize/array_int32_10000", omp, std::vector<int32_t>(10000, 7));
+  const auto int32s = std::vector<int32_t>(10000, 7);
+  run_serialize(r, "serialize/array_int32_span_10000", omp, std::span{ int32s });
+  const auto matrix = std::vector<std::vector<double>>(100, std::vector<double>(100, 0.5));
+  run_serialize(r, "serialize/matrix_double_100x100", omp, matrix);
+  run_serialize(r, "serialize/array_string_1000", omp, std::vector<std::string>(1000, std::string(16, 'x')));
+  run_serialize(r, "serialize/bytea_65536", omp, std::vector<std::byte>(65536, std::byte{ 7 }));
+  run_serialize(r, "serialize/enum", omp, status::suspended);
+  run_serialize(r, "serialize/composite", omp, make_employee(1));
+  run_serialize(r, "serialize/nested_composite_16", omp, make_company(16));
+  run_serialize(r, "serialize/array_composite_1000", omp, make_company(1000).employees);
+}
+} // namespace bench
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <psql/detail/oid_map.hpp>
+#include <psql/detail/type_traits.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace bench
+{
+struct employee
+{
+  std::string name;
+  std::string phone;
+  int32_t age;
+};
+
+enum class status
+{
+  pending,
+  active,
+  suspended,
+  closed
+};
+
+struct company
+{
+  int64_t id;
+  std::string name;
+  std::vector<employee> employees;
+};
+
+inline psql::detail::oid_map make_oid_map()
+{
+  auto omp = psql::detail::oid_map{};
+  omp.emplace(typeid(employee), psql::detail::oid_pair{ 16384, 16383 });
+  omp.emplace(typeid(company), psql::detail::oid_pair{ 16390, 16389 });
+  omp.emplace(typeid(status), psql::detail::oid_pair{ 16396, 16395 });
+  return omp;
+}
+
+inline employee make_employee(int i)
+{
+  return { "Employee " + std::to_string(i), "555-123-" + std::to_string(1000 + i), 20 + i % 40 };
+}
+
+inline company make_company(int employees)
+{
+  auto c = company{ 104, "Company", {} };
+  for (auto i = 0; i < employees; i++)
+    c.employees.push_back(make_employee(i));
+  return c;
+}
+} // namespace bench
+
+namespace psql
+{
+template<>
+struct user_defined<bench::employee>
+{
+  static constexpr auto name    = "employee";
+  static constexpr auto members = std::tuple{ &bench::employee::name, &bench::employee::phone, &bench::employee::age };
+};
+
+template<>
+struct user_defined<bench::status>
+{
+  static constexpr auto name        = "status";
+  static constexpr auto enumerators = std::array{ enumerator{ bench::status::pending, "pending" },
+                                                  enumerator{ bench::status::active, "active" },
+                                                  enumerator{ bench::status::suspended, "suspended" },
+                                                  enumerator{ bench::status::closed, "closed" } };
+};
+
+template<>
+struct user_defined<bench::company>
+{
+  static constexpr auto name    = "company";
+  static constexpr auto members = std::tuple{ &bench::company::id, &bench::company::name, &bench::company::employees };
+};
+} // namespace psql
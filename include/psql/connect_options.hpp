@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace psql
+{
+struct connect_options
+{
+  // Deadline for resolving the hosts and establishing the connection, zero means no deadline.
+  std::chrono::steady_clock::duration timeout{};
+
+  // Maximum delay between starting connection attempts to consecutive addresses, the next attempt starts right away
+  // when the previous one fails. Attempts race each other and the first one that succeeds is kept.
+  std::chrono::steady_clock::duration attempt_delay = std::chrono::milliseconds{ 250 };
+
+  // Single statements (e.g. SET commands) and (name, query) pairs to prepare once the connection is established. They
+  // are sent in one pipeline, which adds a single round trip to the connect operation.
+  std::vector<std::string> init_statements;
+  std::vector<std::pair<std::string, std::string>> prepared_statements;
+};
+} // namespace psql
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <psql/connect_options.hpp>
+#include <psql/detail/conninfo.hpp>
 #include <psql/detail/extract_new_udts.hpp>
+#include <psql/detail/probes.hpp>
+#include <psql/detail/statement_map.hpp>
 #include <psql/notification.hpp>
+#include <psql/observer.hpp>
 #include <psql/pipeline.hpp>
 #include <psql/result.hpp>
 #include <psql/sqlstate.hpp>
@@ -11,9 +16,17 @@
 #include <boost/asio/bind_cancellation_slot.hpp>
 #include <boost/asio/compose.hpp>
 #include <boost/asio/coroutine.hpp>
+#include <boost/asio/deferred.hpp>
+#include <boost/asio/detached.hpp>
 #include <boost/asio/experimental/parallel_group.hpp>
+#include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/posix/stream_descriptor.hpp>
 #include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <chrono>
+#include <deque>
 
 namespace psql
 {
@@ -30,22 +43,89 @@ class basic_connection
     }
   };
 
-  using socket_type = asio::posix::basic_stream_descriptor<Executor>;
-  using wait_type   = typename socket_type::wait_type;
-  using error_code  = boost::system::error_code;
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+  struct pgcancelconn_deleter
+  {
+    void operator()(PGcancelConn* p)
+    {
+      PQcancelFinish(p);
+    }
+  };
+#endif
+
+  using socket_type   = asio::posix::basic_stream_descriptor<Executor>;
+  using timer_type    = typename asio::steady_timer::template rebind_executor<Executor>::other;
+  using resolver_type = asio::ip::basic_resolver<asio::ip::tcp, Executor>;
+  using wait_type     = typename socket_type::wait_type;
+  using error_code    = boost::system::error_code;
+
+  // Shared with the cancel requests and grace timers, which can complete after their operation or the connection.
+  struct cancellation_state
+  {
+    explicit cancellation_state(const Executor& exec)
+      : grace_timer{ exec }
+    {
+    }
+
+    timer_type grace_timer;
+    uint64_t operation = 0; // Identifies the operation that can be cancelled, if any.
+  };
+
+  // Disarms the server-side cancellation of an operation when the operation is destroyed.
+  class cancellation_scope
+  {
+    std::shared_ptr<cancellation_state> state_;
+    uint64_t operation_{};
+
+  public:
+    cancellation_scope() = default;
+
+    cancellation_scope(std::shared_ptr<cancellation_state> state, uint64_t operation)
+      : state_{ std::move(state) }
+      , operation_{ operation }
+    {
+    }
+
+    cancellation_scope(cancellation_scope&&) noexcept = default;
+    cancellation_scope& operator=(cancellation_scope&& other) noexcept
+    {
+      std::swap(state_, other.state_);
+      std::swap(operation_, other.operation_);
+      return *this;
+    }
+
+    ~cancellation_scope()
+    {
+      if (state_ && state_->operation == operation_)
+      {
+        state_->operation++;
+        state_->grace_timer.cancel();
+      }
+    }
+  };
 
   std::unique_ptr<PGconn, pgconn_deleter> pgconn_;
   socket_type socket_;
+  std::shared_ptr<cancellation_state> cancellation_;
+  std::chrono::steady_clock::duration cancel_grace_period_ = std::chrono::seconds{ 5 };
   std::unique_ptr<asio::cancellation_signal> notification_cs_ = std::make_unique<asio::cancellation_signal>();
   detail::oid_map oid_map_;
+  detail::statement_map prepared_statements_;
+  std::unique_ptr<detail::conninfo> conninfo_;
+  std::vector<std::string> init_statements_;
+  std::chrono::steady_clock::duration attempt_delay_{};
   std::vector<detail::udt_pair> new_udts_;
   std::string buffer_;
+  observer* observer_{};
+  bool observing_{};
+  bool awaiting_first_byte_{};
 
 public:
   using executor_type = Executor;
 
   explicit basic_connection(Executor exec)
     : socket_{ std::move(exec) }
+    , cancellation_{ std::make_shared<cancellation_state>(socket_.get_executor()) }
   {
   }
 
@@ -53,6 +133,7 @@ public:
     requires std::is_convertible_v<ExecutionContext&, asio::execution_context&>
   explicit basic_connection(ExecutionContext& context)
     : socket_{ context.get_executor() }
+    , cancellation_{ std::make_shared<cancellation_state>(socket_.get_executor()) }
   {
   }
 
@@ -85,46 +166,168 @@ public:
 
   void close() noexcept
   {
+    // PQfinish handles the closing of the socket.
+    socket_.release();
     pgconn_.reset();
   }
 
+  // The observer is not owned by the connection and must outlive it, or be detached by passing nullptr.
+  void set_observer(observer* observer) noexcept
+  {
+    observer_ = observer;
+  }
+
+  observer* get_observer() const noexcept
+  {
+    return observer_;
+  }
+
+  // How long the server has to abort a cancelled operation before the connection is closed, 5 seconds by default.
+  void set_cancel_grace_period(std::chrono::steady_clock::duration grace_period) noexcept
+  {
+    cancel_grace_period_ = grace_period;
+  }
+
+  // Prepared statements created on this connection through async_prepare, pipeline::push_prepare or connect_options,
+  // and not deallocated through pipeline::push_deallocate.
+  const detail::statement_map& prepared_statements() const noexcept
+  {
+    return prepared_statements_;
+  }
+
+  bool is_prepared(std::string_view stmt_name) const noexcept
+  {
+    return prepared_statements_.contains(stmt_name);
+  }
+
+  bool is_prepared(std::string_view stmt_name, std::string_view query) const noexcept
+  {
+    auto it = prepared_statements_.find(stmt_name);
+    return it != prepared_statements_.end() && it->second == query;
+  }
+
   template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
   auto async_connect(std::string conninfo, CompletionToken&& token = CompletionToken{})
+  {
+    return async_connect(std::move(conninfo), connect_options{}, std::forward<CompletionToken>(token));
+  }
+
+  template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
+  auto async_connect(std::string conninfo, connect_options options, CompletionToken&& token = CompletionToken{})
   {
     return asio::async_compose<CompletionToken, void(error_code)>(
-      [this, conninfo = std::move(conninfo), init = true](auto& self, error_code ec = {}) mutable
+      [this,
+       coro     = asio::coroutine{},
+       conninfo = std::move(conninfo),
+       options  = std::move(options),
+       params   = std::make_unique<detail::conninfo>(),
+       timer    = std::make_unique<timer_type>(socket_.get_executor()),
+       cs       = std::make_shared<asio::cancellation_signal>()](
+        auto& self, error_code ec = {}, std::vector<result> = {}) mutable
       {
         if (ec)
+        {
+          auto expired = options.timeout != std::chrono::steady_clock::duration::zero() &&
+                         timer->expiry() <= std::chrono::steady_clock::now();
+
+          if (ec == asio::error::operation_aborted && expired)
+            ec = error::timeout_expired;
+
+          cs->slot().clear();
+          asio::get_associated_cancellation_slot(self).clear();
           return self.complete(ec);
+        }
 
-        if (std::exchange(init, false))
+        BOOST_ASIO_CORO_REENTER(coro)
         {
-          pgconn_.reset(PQconnectStart(conninfo.data()));
+          if (!params->parse(conninfo))
+            return asio::post(asio::append(std::move(self), error::pq_conninfo_parse_failed));
 
-          if (PQstatus(pgconn_.get()) == CONNECTION_BAD)
-            return asio::post(asio::append(std::move(self), error::pq_connect_start_failed));
+          if (auto slot = asio::get_associated_cancellation_slot(self); slot.is_connected())
+            slot.assign([cs = cs.get()](auto c) { cs->emit(c); });
 
-          if (PQsetnonblocking(pgconn_.get(), 1))
-            return asio::post(asio::append(std::move(self), error::pq_set_non_blocking_failed));
+          if (options.timeout != std::chrono::steady_clock::duration::zero())
+          {
+            timer->expires_after(options.timeout);
+            timer->async_wait(
+              [cs](error_code ec)
+              {
+                if (!ec)
+                  cs->emit(asio::cancellation_type::terminal);
+              });
+          }
 
-          PQsetNoticeProcessor(
-            pgconn_.get(), +[](void*, const char*) {}, nullptr);
+          BOOST_ASIO_CORO_YIELD async_race_connect_attempts(
+            *params, options.attempt_delay, asio::bind_cancellation_slot(cs->slot(), std::move(self)));
+
+          // Kept for async_reset.
+          conninfo_        = std::move(params);
+          init_statements_ = std::move(options.init_statements);
+          attempt_delay_   = options.attempt_delay;
+
+          if (!init_statements_.empty() || !options.prepared_statements.empty())
+          {
+            BOOST_ASIO_CORO_YIELD async_exec_pipeline(
+              [this, prepared_statements = std::move(options.prepared_statements)](psql::pipeline& p)
+              {
+                for (const auto& statement : init_statements_)
+                  p.push_query(statement);
+
+                for (const auto& [stmt_name, query] : prepared_statements)
+                  p.push_prepare(stmt_name, query);
+              },
+              asio::bind_cancellation_slot(cs->slot(), std::move(self)));
+          }
 
-          socket_.assign(PQsocket(pgconn_.get()));
+          cs->slot().clear();
+          asio::get_associated_cancellation_slot(self).clear();
+          return self.complete({});
         }
+      },
+      token,
+      socket_);
+  }
 
-        auto ret = PQconnectPoll(pgconn_.get());
+  // Reestablishes a broken connection with the parameters of the last async_connect. The hosts are resolved again and
+  // the attempts race each other as in async_connect, so the connection can fail over to another host or address. The
+  // OIDs of user-defined types are kept, and the init statements and the prepared statements of the connection are sent
+  // again in one pipeline.
+  template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
+  auto async_reset(CompletionToken&& token = CompletionToken{})
+  {
+    return asio::async_compose<CompletionToken, void(error_code)>(
+      [this, coro = asio::coroutine{}, statements = detail::statement_map{}](
+        auto& self, error_code ec = {}, std::vector<result> = {}) mutable
+      {
+        if (ec)
+          return self.complete(ec);
 
-        if (ret == PGRES_POLLING_READING)
-          return socket_.async_wait(wait_type::wait_read, std::move(self));
+        BOOST_ASIO_CORO_REENTER(coro)
+        {
+          if (!conninfo_)
+            return asio::post(asio::append(std::move(self), error::not_connected));
 
-        if (ret == PGRES_POLLING_WRITING)
-          return socket_.async_wait(wait_type::wait_write, std::move(self));
+          // The prepared statements are cleared once a new connection is established.
+          statements = prepared_statements_;
 
-        if (ret == PGRES_POLLING_FAILED)
-          return asio::post(asio::append(std::move(self), error::connection_failed));
+          BOOST_ASIO_CORO_YIELD async_race_connect_attempts(*conninfo_, attempt_delay_, std::move(self));
+
+          if (!init_statements_.empty() || !statements.empty())
+          {
+            BOOST_ASIO_CORO_YIELD async_exec_pipeline(
+              [this, statements = std::move(statements)](psql::pipeline& p)
+              {
+                for (const auto& statement : init_statements_)
+                  p.push_query(statement);
+
+                for (const auto& [stmt_name, query] : statements)
+                  p.push_prepare(stmt_name, query);
+              },
+              std::move(self));
+          }
 
-        return self.complete({});
+          return self.complete({});
+        }
       },
       token,
       socket_);
@@ -135,14 +338,22 @@ public:
   {
     return asio::async_compose<CompletionToken, void(error_code, std::vector<result>)>(
       [this,
-       coro      = asio::coroutine{},
-       results   = std::vector<result>{},
-       is_thrown = false,
-       index     = size_t{},
-       operation = std::forward<Operation>(operation)](auto& self, error_code ec = {}, result result = {}) mutable
+       coro             = asio::coroutine{},
+       results          = std::vector<result>{},
+       is_thrown        = false,
+       index            = size_t{},
+       bytes_serialized = size_t{},
+       prepares         = std::vector<std::tuple<size_t, std::string, std::string>>{},
+       deallocates      = std::vector<std::pair<size_t, std::string>>{},
+       cancellation     = cancellation_scope{},
+       operation        = std::forward<Operation>(operation)](
+        auto& self, error_code ec = {}, result result = {}) mutable
       {
         if (ec)
+        {
+          observe_complete(ec, results);
           return self.complete(ec, {});
+        }
 
         BOOST_ASIO_CORO_REENTER(coro)
         {
@@ -161,41 +372,89 @@ public:
               pipeline.push_query("ROLLBACK;");
             }
             results.resize(pipeline.size());
+            bytes_serialized = pipeline.bytes_serialized();
+            prepares         = std::move(pipeline.prepares());
+            deallocates      = std::move(pipeline.deallocates());
           }
 
           if (!PQpipelineSync(pgconn_.get()))
             return self.complete(error::pq_pipeline_sync_failed, {});
 
-          BOOST_ASIO_CORO_YIELD async_flush(std::move(self));
+          PSQL_PROBE(pipeline__sync, this, results.size());
+
+          observe_send(operation::pipeline, {}, bytes_serialized);
+
+          cancellation = enable_server_side_cancellation(self);
+
+          BOOST_ASIO_CORO_YIELD async_flush(without_cancellation(std::move(self)));
 
           while (index < results.size())
           {
-            BOOST_ASIO_CORO_YIELD async_receive_result(std::move(self));
+            BOOST_ASIO_CORO_YIELD async_receive_result(without_cancellation(std::move(self)));
             results[index] = std::move(result);
-            BOOST_ASIO_CORO_YIELD async_receive_result(std::move(self));
+            BOOST_ASIO_CORO_YIELD async_receive_result(without_cancellation(std::move(self)));
             if (result)
+            {
+              observe_complete(error::unexpected_non_null_result, results);
               return self.complete(error::unexpected_non_null_result, {});
+            }
             index++;
           }
 
-          BOOST_ASIO_CORO_YIELD async_receive_result(std::move(self));
+          // Applied in pipeline order, as a statement can be deallocated and prepared again in the same pipeline.
+          {
+            auto deallocate = deallocates.begin();
+            const auto apply_deallocates = [&](size_t end)
+            {
+              for (; deallocate != deallocates.end() && deallocate->first < end; deallocate++)
+              {
+                if (PQresultStatus(results[deallocate->first].native_handle()) == PGRES_COMMAND_OK)
+                  prepared_statements_.erase(deallocate->second);
+              }
+            };
+
+            for (auto& [i, stmt_name, query] : prepares)
+            {
+              apply_deallocates(i);
+              if (PQresultStatus(results[i].native_handle()) == PGRES_COMMAND_OK)
+                prepared_statements_.insert_or_assign(std::move(stmt_name), std::move(query));
+            }
+            apply_deallocates(results.size());
+          }
+
+          BOOST_ASIO_CORO_YIELD async_receive_result(without_cancellation(std::move(self)));
           if (PQresultStatus(result.native_handle()) != PGRES_PIPELINE_SYNC)
+          {
+            observe_complete(error::result_status_unexpected, results);
             return self.complete(error::result_status_unexpected, {});
+          }
 
           if (!PQexitPipelineMode(pgconn_.get()))
+          {
+            observe_complete(error::pq_exit_pipeline_mode_failed, results);
             return self.complete(error::pq_exit_pipeline_mode_failed, {});
+          }
 
           notification_cs_->emit(asio::cancellation_type::terminal);
 
           if (is_thrown)
+          {
+            observe_complete(error::exception_in_pipeline_operation, results);
             return self.complete(error::exception_in_pipeline_operation, {});
+          }
 
           for (const auto& result : results)
           {
             if (auto ec = result_status_to_error_code(result))
+            {
+              if (!!self.cancelled() && ec == sqlstate::query_canceled)
+                ec = asio::error::operation_aborted;
+              observe_complete(ec, results);
               return self.complete(ec, std::move(results));
+            }
           }
 
+          observe_complete({}, results);
           return self.complete({}, std::move(results));
         }
       },
@@ -227,12 +486,23 @@ public:
               return self.complete(ec, {});
           }
 
+          // Values that can't be encoded, such as ragged ranges, are reported before anything is sent.
+          try
           {
             auto [t, v, l, f] = detail::serialize(oid_map_, buffer_, params);
 
             if (!PQsendQueryParams(pgconn_.get(), query.data(), t.size(), t.data(), v.data(), l.data(), f.data(), 1))
-              return self.complete(error::pq_send_query_params_failed, {});
+              ec = error::pq_send_query_params_failed;
           }
+          catch (const boost::system::system_error& e)
+          {
+            ec = e.code();
+          }
+
+          if (ec)
+            return self.complete(ec, {});
+
+          observe_send(operation::query, query, buffer_.size());
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
           return self.complete(ec, std::move(result));
         }
@@ -253,7 +523,13 @@ public:
           if (!PQsendPrepare(pgconn_.get(), stmt_name.data(), query.data(), 0, nullptr))
             return self.complete(error::pq_send_prepare_failed, {});
 
+          observe_send(operation::prepare, stmt_name, 0);
+
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
+
+          if (!ec)
+            prepared_statements_.insert_or_assign(std::move(stmt_name), std::move(query));
+
           return self.complete(ec, std::move(result));
         }
       },
@@ -285,12 +561,22 @@ public:
               return self.complete(ec, {});
           }
 
+          try
           {
             auto [t, v, l, f] = detail::serialize(oid_map_, buffer_, params);
 
             if (!PQsendQueryPrepared(pgconn_.get(), stmt_name.data(), t.size(), v.data(), l.data(), f.data(), 1))
-              return self.complete(error::pq_send_query_prepared_failed, {});
+              ec = error::pq_send_query_prepared_failed;
           }
+          catch (const boost::system::system_error& e)
+          {
+            ec = e.code();
+          }
+
+          if (ec)
+            return self.complete(ec, {});
+
+          observe_send(operation::query_prepared, stmt_name, buffer_.size());
 
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
           return self.complete(ec, std::move(result));
@@ -312,6 +598,8 @@ public:
           if (!PQsendDescribePrepared(pgconn_.get(), stmt_name.data()))
             return self.complete(error::pq_send_describe_prepared_failed, {});
 
+          observe_send(operation::describe_prepared, stmt_name, 0);
+
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
           return self.complete(ec, std::move(result));
         }
@@ -332,6 +620,8 @@ public:
           if (!PQsendDescribePortal(pgconn_.get(), portal_name.data()))
             return self.complete(error::pq_send_describe_portal_failed, {});
 
+          observe_send(operation::describe_portal, portal_name, 0);
+
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
           return self.complete(ec, std::move(result));
         }
@@ -340,6 +630,58 @@ public:
       socket_);
   }
 
+  // Runs a deferred operation of this connection (e.g. `conn.async_query(query, asio::deferred)`) and completes with
+  // error::timeout_expired if it doesn't complete within `timeout`. The deadline doesn't depend on the server: once it
+  // expires a cancel request is sent, so that the server stops the query, and the connection is closed, which aborts
+  // the operation. The connection can be reestablished with async_reset.
+  template<typename Operation, typename CompletionToken = asio::default_completion_token_t<executor_type>>
+  auto async_with_timeout(
+    std::chrono::steady_clock::duration timeout,
+    Operation&& operation,
+    CompletionToken&& token = CompletionToken{})
+  {
+    using value_type = typename completion_value<asio::completion_signature_of_t<std::decay_t<Operation>>>::type;
+
+    return asio::async_compose<CompletionToken, void(error_code, value_type)>(
+      [this,
+       timeout,
+       coro      = asio::coroutine{},
+       timer     = std::make_unique<timer_type>(socket_.get_executor()),
+       running   = std::make_shared<bool>(true),
+       operation = std::forward<Operation>(operation)](
+        auto& self, error_code ec = {}, value_type value = {}) mutable
+      {
+        BOOST_ASIO_CORO_REENTER(coro)
+        {
+          timer->expires_after(timeout);
+          timer->async_wait(
+            [this, running](error_code ec)
+            {
+              if (ec || !*running)
+                return;
+
+              async_cancel_on_server(asio::detached);
+              close();
+            });
+
+          BOOST_ASIO_CORO_YIELD std::move(operation)(std::move(self));
+
+          *running = false;
+
+          if (timer->expiry() <= std::chrono::steady_clock::now())
+          {
+            close();
+            return self.complete(error::timeout_expired, {});
+          }
+
+          timer->cancel();
+          return self.complete(ec, std::move(value));
+        }
+      },
+      token,
+      socket_);
+  }
+
   template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
   auto async_receive_notifcation(CompletionToken&& token = CompletionToken{})
   {
@@ -389,6 +731,231 @@ public:
   }
 
 private:
+  template<typename Signature>
+  struct completion_value;
+
+  template<typename T>
+  struct completion_value<void(error_code, T)>
+  {
+    using type = T;
+  };
+
+  // Races connection attempts to the targets of the connection string (RFC 8305). Host names are resolved
+  // concurrently, as libpq would block while resolving them in PQconnectStartParams, and each resolved address becomes
+  // a separate attempt as soon as it is available, in the order of the targets. An attempt starts once the previous
+  // one has failed, or `attempt_delay` after the previous one started, and the first connection that is established is
+  // kept. Options that make libpq choose among all the hosts (see conninfo::whole_list) get a single attempt with all
+  // the resolved addresses instead.
+  template<typename CompletionToken>
+  auto async_race_connect_attempts(
+    const detail::conninfo& params,
+    std::chrono::steady_clock::duration attempt_delay,
+    CompletionToken&& token)
+  {
+    struct race_state
+    {
+      explicit race_state(const executor_type& exec)
+        : wakeup{ exec }
+      {
+      }
+
+      timer_type wakeup;
+      std::deque<resolver_type> resolvers;
+      std::deque<asio::cancellation_signal> signals;
+      std::deque<std::pair<size_t, detail::connect_target>> pending;
+      std::chrono::steady_clock::time_point next_start;
+      size_t outstanding = 0;
+      bool connected     = false;
+      bool stopping      = false;
+      error_code last_ec = error::connection_failed;
+      decltype(pgconn_) pgconn; // The established connection, or the last one that failed for its error message.
+
+      void push(size_t index, detail::connect_target target)
+      {
+        auto it = std::find_if(pending.begin(), pending.end(), [&](const auto& p) { return p.first > index; });
+        pending.emplace(it, index, std::move(target));
+      }
+    };
+
+    return asio::async_compose<CompletionToken, void(error_code)>(
+      [this,
+       &params,
+       attempt_delay,
+       coro  = asio::coroutine{},
+       state = std::make_unique<race_state>(socket_.get_executor())](auto& self, error_code = {}) mutable
+      {
+        // Completions of the resolutions and attempts only update the state and wake up the coroutine, which also
+        // wakes up when the next attempt is due or the operation is cancelled.
+        BOOST_ASIO_CORO_REENTER(coro)
+        {
+          for (size_t i = 0; i < params.targets().size(); i++)
+          {
+            if (!params.targets()[i].needs_resolution())
+            {
+              state->push(i, params.targets()[i]);
+              continue;
+            }
+
+            state->outstanding++;
+            state->resolvers.emplace_back(socket_.get_executor())
+              .async_resolve(
+                params.targets()[i].host,
+                "",
+                asio::bind_cancellation_slot(
+                  state->signals.emplace_back().slot(),
+                  [state = state.get(), i, target = params.targets()[i]](
+                    error_code ec, typename resolver_type::results_type endpoints)
+                  {
+                    state->outstanding--;
+
+                    // libpq would skip a host that can't be resolved and try the next one.
+                    if (ec && ec != asio::error::operation_aborted)
+                      state->last_ec = ec;
+
+                    for (const auto& entry : endpoints)
+                      state->push(i, { target.host, entry.endpoint().address().to_string(), target.port });
+
+                    state->wakeup.cancel();
+                  }));
+          }
+
+          // Without hosts, libpq connects to its default.
+          if (params.targets().empty())
+            state->push(0, {});
+
+          for (;;)
+          {
+            if (!!self.cancelled() || state->connected)
+            {
+              if (!std::exchange(state->stopping, true))
+                for (auto& signal : state->signals)
+                  signal.emit(asio::cancellation_type::terminal);
+            }
+            else if (
+              !state->pending.empty() && state->next_start <= std::chrono::steady_clock::now() &&
+              !(params.whole_list() && state->outstanding != 0))
+            {
+              auto targets = std::vector<detail::connect_target>{};
+              do
+              {
+                targets.push_back(std::move(state->pending.front().second));
+                state->pending.pop_front();
+              } while (params.whole_list() && !state->pending.empty());
+
+              state->outstanding++;
+              state->next_start = std::chrono::steady_clock::now() + attempt_delay;
+              async_connect_attempt(
+                params,
+                std::move(targets),
+                asio::bind_cancellation_slot(
+                  state->signals.emplace_back().slot(),
+                  [state = state.get()](error_code ec, decltype(pgconn_) pgconn)
+                  {
+                    state->outstanding--;
+
+                    if (!state->connected)
+                    {
+                      state->connected = !ec;
+                      state->last_ec   = ec;
+                      state->pgconn    = std::move(pgconn);
+
+                      // The next attempt starts right away when one fails.
+                      if (ec)
+                        state->next_start = {};
+                    }
+
+                    state->wakeup.cancel();
+                  }));
+              continue;
+            }
+
+            if (state->outstanding == 0 && (state->stopping || state->pending.empty()))
+              break;
+
+            BOOST_ASIO_CORO_YIELD
+            {
+              const auto idle = state->stopping || state->pending.empty() ||
+                                (params.whole_list() && state->outstanding != 0);
+              state->wakeup.expires_at(idle ? std::chrono::steady_clock::time_point::max() : state->next_start);
+              state->wakeup.async_wait(std::move(self));
+            }
+          }
+
+          socket_.release();
+          pgconn_ = std::move(state->pgconn);
+          prepared_statements_.clear();
+          if (pgconn_ && PQsocket(pgconn_.get()) != -1)
+            socket_.assign(PQsocket(pgconn_.get()));
+
+          if (state->connected)
+            return self.complete({});
+
+          return self.complete(!!self.cancelled() ? error_code{ asio::error::operation_aborted } : state->last_ec);
+        }
+      },
+      token,
+      socket_);
+  }
+
+  template<typename CompletionToken>
+  auto async_connect_attempt(
+    const detail::conninfo& params,
+    std::vector<detail::connect_target> targets,
+    CompletionToken&& token)
+  {
+    return asio::async_compose<CompletionToken, void(error_code, decltype(pgconn_))>(
+      [&params,
+       coro    = asio::coroutine{},
+       targets = std::move(targets),
+       pgconn  = decltype(pgconn_){},
+       socket  = std::make_unique<socket_type>(socket_.get_executor())](auto& self, error_code ec = {}) mutable
+      {
+        // The socket is owned by the PGconn.
+        if (socket->is_open())
+          socket->release();
+
+        if (ec)
+          return self.complete(ec, std::move(pgconn));
+
+        BOOST_ASIO_CORO_REENTER(coro)
+        {
+          // PQconnectStartParams doesn't block with resolved addresses.
+          pgconn.reset(params.connect_start(targets));
+
+          if (PQstatus(pgconn.get()) == CONNECTION_BAD)
+            return asio::post(asio::append(std::move(self), error::pq_connect_start_failed));
+
+          if (PQsetnonblocking(pgconn.get(), 1))
+            return asio::post(asio::append(std::move(self), error::pq_set_non_blocking_failed));
+
+          PQsetNoticeProcessor(
+            pgconn.get(), +[](void*, const char*) {}, nullptr);
+
+          for (;;)
+          {
+            BOOST_ASIO_CORO_YIELD
+            {
+              auto ret = PQconnectPoll(pgconn.get());
+
+              if (ret == PGRES_POLLING_FAILED)
+                return asio::post(asio::append(std::move(self), error::connection_failed));
+
+              if (ret == PGRES_POLLING_OK)
+                return self.complete({}, std::move(pgconn));
+
+              // libpq might open a new socket, possibly reusing the previous descriptor number, so the socket is
+              // registered again after each poll.
+              socket->assign(PQsocket(pgconn.get()));
+              socket->async_wait(
+                ret == PGRES_POLLING_READING ? wait_type::wait_read : wait_type::wait_write, std::move(self));
+            }
+          }
+        }
+      },
+      token,
+      socket_);
+  }
+
   template<typename CompletionToken>
   auto async_flush(CompletionToken&& token)
   {
@@ -402,6 +969,8 @@ private:
 
           if (!PQconsumeInput(pgconn_.get()))
             return self.complete(error::pq_consume_input_failed);
+
+          observe_first_byte();
         }
         else
         {
@@ -409,6 +978,7 @@ private:
             return self.complete(ec1);
 
           const int ret = PQflush(pgconn_.get());
+          PSQL_PROBE(flush, this, ret);
 
           if (ret == -1)
             return self.complete(error::pq_flush_failed);
@@ -443,14 +1013,21 @@ private:
             BOOST_ASIO_CORO_YIELD socket_.async_wait(wait_type::wait_read, std::move(self));
             if (!PQconsumeInput(pgconn_.get()))
               return self.complete(error::pq_consume_input_failed, {});
+            observe_first_byte();
           }
 
           if (needs_rescheduling)
           {
             BOOST_ASIO_CORO_YIELD asio::post(socket_.get_executor(), std::move(self));
+
+            // The connection is closed when a cancelled operation can't be cancelled on the server.
+            if (!pgconn_)
+              return self.complete(asio::error::operation_aborted, {});
           }
 
-          return self.complete({}, result{ PQgetResult(pgconn_.get()) });
+          auto* pgresult = PQgetResult(pgconn_.get());
+          PSQL_PROBE(result__receive, this, pgresult, PQresultStatus(pgresult));
+          return self.complete({}, result{ pgresult });
         }
       },
       token,
@@ -463,7 +1040,10 @@ private:
       [this, coro = asio::coroutine{}](auto& self, error_code ec = {}, result result = {}) mutable
       {
         if (ec)
+        {
+          PSQL_PROBE(oids__done, this, ec.value());
           return self.complete(ec);
+        }
 
         BOOST_ASIO_CORO_REENTER(coro)
         {
@@ -491,21 +1071,30 @@ private:
               return self.complete(error::pq_send_query_params_failed);
           }
 
+          PSQL_PROBE(oids__start, this, new_udts_.size());
+
           BOOST_ASIO_CORO_YIELD async_generic_single_result_query(std::move(self));
 
           if (auto ec = result_status_to_error_code(result))
+          {
+            PSQL_PROBE(oids__done, this, ec.value());
             return self.complete(ec);
+          }
 
           for (size_t i = 0; i < result.size(); i++)
           {
             auto [type_oid, array_oid] = as<uint32_t, uint32_t>(result.at(i));
 
             if (type_oid == 0xFFFFFFFF || array_oid == 0xFFFFFFFF)
+            {
+              PSQL_PROBE(oids__done, this, static_cast<int>(error::user_defined_type_does_not_exist));
               return self.complete(error::user_defined_type_does_not_exist);
+            }
 
             oid_map_.emplace(new_udts_.at(i).type_index, detail::oid_pair{ type_oid, array_oid });
           }
 
+          PSQL_PROBE(oids__done, this, 0);
           return self.complete({});
         }
       },
@@ -523,25 +1112,36 @@ private:
   void async_generic_single_result_query_erased(asio::any_completion_handler<void(error_code, result)> handler)
   {
     return asio::async_compose<decltype(handler), void(error_code, result)>(
-      [this, coro = asio::coroutine{}, stored_result = result{}](
+      [this, coro = asio::coroutine{}, stored_result = result{}, cancellation = cancellation_scope{}](
         auto& self, error_code ec = {}, result result = {}) mutable
       {
         if (ec)
+        {
+          observe_complete(ec, stored_result);
           return self.complete(ec, {});
+        }
 
         BOOST_ASIO_CORO_REENTER(coro)
         {
-          BOOST_ASIO_CORO_YIELD async_flush(std::move(self));
+          cancellation = enable_server_side_cancellation(self);
+
+          BOOST_ASIO_CORO_YIELD async_flush(without_cancellation(std::move(self)));
 
-          BOOST_ASIO_CORO_YIELD async_receive_result(std::move(self));
+          BOOST_ASIO_CORO_YIELD async_receive_result(without_cancellation(std::move(self)));
           stored_result = std::move(result);
 
-          BOOST_ASIO_CORO_YIELD async_receive_result(std::move(self));
+          BOOST_ASIO_CORO_YIELD async_receive_result(without_cancellation(std::move(self)));
           if (result)
+          {
+            observe_complete(error::unexpected_non_null_result, stored_result);
             return self.complete(error::unexpected_non_null_result, {});
+          }
 
           notification_cs_->emit(asio::cancellation_type::terminal);
           auto result_ec = result_status_to_error_code(stored_result);
+          if (!!self.cancelled() && result_ec == sqlstate::query_canceled)
+            result_ec = asio::error::operation_aborted;
+          observe_complete(result_ec, stored_result);
           return self.complete(result_ec, std::move(stored_result));
         }
       },
@@ -556,6 +1156,159 @@ private:
       [this](auto handler) { async_generic_single_result_query_erased(std::move(handler)); }, token);
   }
 
+  // Cancelling an operation that is waiting for its results sends a cancel request to the server. The operation keeps
+  // draining the results, so it completes once the server aborts the query and leaves the connection usable. If the
+  // request can't be sent, or the server doesn't abort the query within the grace period, the connection is closed,
+  // which aborts the operation.
+  template<typename Self>
+  cancellation_scope enable_server_side_cancellation(Self& self)
+  {
+    const auto operation = ++cancellation_->operation;
+    cancellation_->grace_timer.cancel();
+
+    if (auto slot = asio::get_associated_cancellation_slot(self); slot.is_connected())
+    {
+      slot.assign(
+        [this, operation, state = std::weak_ptr{ cancellation_ }](asio::cancellation_type)
+        {
+          // The slot can outlive the operation.
+          if (auto sp = state.lock(); !sp || sp->operation != operation)
+            return;
+
+          async_cancel_on_server(
+            [this, operation, state = cancellation_](error_code ec)
+            {
+              if (state->operation != operation)
+                return;
+
+              if (ec)
+                return close();
+
+              state->grace_timer.expires_after(cancel_grace_period_);
+              state->grace_timer.async_wait(
+                [this, operation, state = std::weak_ptr{ state }](error_code ec)
+                {
+                  if (auto sp = state.lock(); !ec && sp && sp->operation == operation)
+                    close();
+                });
+            });
+        });
+    }
+
+    return { cancellation_, operation };
+  }
+
+  template<typename Self>
+  static auto without_cancellation(Self&& self)
+  {
+    return asio::bind_cancellation_slot(asio::cancellation_slot{}, std::forward<Self>(self));
+  }
+
+  // Completes with an error if the cancel request couldn't be sent. Without the asynchronous cancel API (libpq < 17),
+  // PQcancel would block the executor while it connects to the server, so no request is sent and the operation fails.
+  template<typename CompletionToken>
+  auto async_cancel_on_server(CompletionToken&& token)
+  {
+    return asio::async_initiate<CompletionToken, void(error_code)>(
+      [this](auto handler)
+      {
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+        if (pgconn_)
+        {
+          auto cancel_conn = std::unique_ptr<PGcancelConn, pgcancelconn_deleter>{ PQcancelCreate(pgconn_.get()) };
+
+          if (PQcancelStart(cancel_conn.get()))
+            return async_poll_cancel(std::move(cancel_conn), std::move(handler));
+        }
+#endif
+        asio::post(socket_.get_executor(), asio::append(std::move(handler), error_code{ error::connection_failed }));
+      },
+      token);
+  }
+
+#ifdef LIBPQ_HAS_ASYNC_CANCEL
+  template<typename CompletionToken>
+  auto async_poll_cancel(std::unique_ptr<PGcancelConn, pgcancelconn_deleter> cancel_conn, CompletionToken&& token)
+  {
+    return asio::async_compose<CompletionToken, void(error_code)>(
+      [cancel_conn = std::move(cancel_conn),
+       socket      = std::make_unique<socket_type>(socket_.get_executor()),
+       started     = false](auto& self, error_code ec = {}) mutable
+      {
+        // The socket is owned by the PGcancelConn.
+        if (socket->is_open())
+          socket->release();
+
+        if (ec)
+          return self.complete(ec);
+
+        // PQcancelStart behaves as if PQcancelPoll had returned PGRES_POLLING_WRITING.
+        auto ret = std::exchange(started, true) ? PQcancelPoll(cancel_conn.get()) : PGRES_POLLING_WRITING;
+
+        if (ret == PGRES_POLLING_FAILED)
+          return self.complete(error::connection_failed);
+
+        if (ret == PGRES_POLLING_OK)
+          return self.complete({});
+
+        socket->assign(PQcancelSocket(cancel_conn.get()));
+        socket->async_wait(
+          ret == PGRES_POLLING_READING ? wait_type::wait_read : wait_type::wait_write, std::move(self));
+      },
+      token,
+      socket_);
+  }
+#endif
+
+  void observe_send(operation op, std::string_view text, std::size_t bytes_serialized)
+  {
+    PSQL_PROBE(query__start, this, static_cast<int>(op), text.data(), bytes_serialized);
+
+    // The size of the results is only computed on completion if something consumes it.
+    observing_ = PSQL_PROBES_ENABLED || observer_;
+
+    if (observer_)
+    {
+      awaiting_first_byte_ = true;
+      observer_->on_send(op, text, bytes_serialized);
+    }
+  }
+
+  void observe_first_byte()
+  {
+    if (observer_ && std::exchange(awaiting_first_byte_, false))
+      observer_->on_first_byte();
+  }
+
+  void observe_complete(error_code ec, const result& result)
+  {
+    if (std::exchange(observing_, false))
+      notify_complete(ec, PQresultMemorySize(result.native_handle()));
+  }
+
+  void observe_complete(error_code ec, const std::vector<result>& results)
+  {
+    if (std::exchange(observing_, false))
+    {
+      auto result_size = std::size_t{};
+      for (const auto& result : results)
+        result_size += PQresultMemorySize(result.native_handle());
+
+      notify_complete(ec, result_size);
+    }
+  }
+
+  void notify_complete(error_code ec, std::size_t result_size)
+  {
+    PSQL_PROBE(query__done, this, ec.value(), result_size);
+
+    if (observer_)
+    {
+      awaiting_first_byte_ = false;
+      observer_->on_complete(ec, result_size);
+    }
+  }
+
   static error_code result_status_to_error_code(const result& result) noexcept
   {
     switch (PQresultStatus(result.native_handle()))
@@ -69,6 +69,8 @@ class basic_connection_pool_impl : public std::enable_shared_from_this<basic_con
   Executor exec_;
   asio::steady_timer cv_;
   std::string conninfo_;
+  connect_options connect_options_;
+  detail::statement_map statements_;
   size_t max_size_{};
   size_t aquired_conns_{};
   std::queue<basic_connection<Executor>> idle_conns_;
@@ -76,10 +78,11 @@ class basic_connection_pool_impl : public std::enable_shared_from_this<basic_con
 public:
   using executor_type = Executor;
 
-  basic_connection_pool_impl(Executor exec, std::string conninfo, size_t max_size = 32)
+  basic_connection_pool_impl(Executor exec, std::string conninfo, connect_options options, size_t max_size = 32)
     : exec_{ exec }
     , cv_{ std::move(exec), asio::steady_timer::time_point::max() }
     , conninfo_{ std::move(conninfo) }
+    , connect_options_{ std::move(options) }
     , max_size_{ max_size }
   {
   }
@@ -108,12 +111,34 @@ public:
     return aquired_conns_;
   }
 
+  void register_statement(std::string stmt_name, std::string query)
+  {
+    auto lg = std::lock_guard<std::mutex>{ mtx_ };
+    statements_.insert_or_assign(std::move(stmt_name), std::move(query));
+  }
+
+  void unregister_statement(std::string_view stmt_name)
+  {
+    auto lg = std::lock_guard<std::mutex>{ mtx_ };
+    if (auto it = statements_.find(stmt_name); it != statements_.end())
+      statements_.erase(it);
+  }
+
+  bool is_registered(std::string_view stmt_name)
+  {
+    auto lg = std::lock_guard<std::mutex>{ mtx_ };
+    return statements_.contains(stmt_name);
+  }
+
   template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
   auto async_aquire(CompletionToken&& token = CompletionToken{})
   {
     return asio::async_compose<CompletionToken, void(error_code, basic_pooled_connection<executor_type>)>(
-      [this, coro = asio::coroutine{}, conn = std::make_unique<basic_connection<Executor>>(exec_)](
-        auto& self, error_code ec = {}) mutable
+      [this,
+       coro     = asio::coroutine{},
+       conn     = std::make_unique<basic_connection<Executor>>(exec_),
+       prepares = std::vector<std::tuple<size_t, std::string, std::string>>{}](
+        auto& self, error_code ec = {}, std::vector<result> results = {}) mutable
       {
         auto lg = std::unique_lock<std::mutex>{ mtx_ };
 
@@ -121,10 +146,13 @@ public:
         {
           self.reset_cancellation_state(asio::enable_total_cancellation());
 
+          PSQL_PROBE(acquire__start, this, aquired_conns_, idle_conns_.size());
+
           while (aquired_conns_ >= max_size_)
           {
             if ((ec && ec != asio::error::operation_aborted) || !!self.cancelled())
             {
+              PSQL_PROBE(acquire__done, this, ec.value());
               lg.unlock();
               return self.complete(ec, { {}, std::move(*conn) });
             }
@@ -136,15 +164,77 @@ public:
 
           if (idle_conns_.empty())
           {
-            BOOST_ASIO_CORO_YIELD conn->async_connect(conninfo_, std::move(self));
+            BOOST_ASIO_CORO_YIELD
+            {
+              lg.unlock();
+              conn->async_connect(conninfo_, connect_options_, std::move(self));
+            }
+
+            if (ec)
+            {
+              PSQL_PROBE(acquire__done, this, ec.value());
+              lg.unlock();
+              return self.complete(ec, { this->weak_from_this(), std::move(*conn) });
+            }
           }
           else
           {
             *conn = std::move(idle_conns_.front());
             idle_conns_.pop();
-            BOOST_ASIO_CORO_YIELD asio::post(std::move(self));
           }
 
+          // Prepares the registered statements that the connection misses. A statement that was prepared under the same
+          // name with another query is deallocated first.
+          BOOST_ASIO_CORO_YIELD
+          {
+            auto deallocate = std::vector<bool>{};
+            auto index      = size_t{};
+            prepares.clear();
+            for (const auto& [stmt_name, query] : statements_)
+            {
+              if (conn->is_prepared(stmt_name, query))
+                continue;
+
+              deallocate.push_back(conn->is_prepared(stmt_name));
+              index += deallocate.back();
+              prepares.emplace_back(index++, stmt_name, query);
+            }
+
+            lg.unlock();
+
+            if (prepares.empty())
+              return asio::post(std::move(self));
+
+            conn->async_exec_pipeline(
+              [deallocate = std::move(deallocate), prepares = prepares](psql::pipeline& p)
+              {
+                for (size_t i = 0; i < prepares.size(); i++)
+                {
+                  if (deallocate[i])
+                    p.push_deallocate(std::get<1>(prepares[i]));
+
+                  p.push_prepare(std::get<1>(prepares[i]), std::get<2>(prepares[i]));
+                }
+              },
+              std::move(self));
+          }
+
+          // A statement that fails to prepare is rejected, so it can't fail every acquisition. The statements after it
+          // in the pipeline are aborted, and prepared on the next acquisition. The connection is still handed out, as
+          // only the errors of the connection itself come without results.
+          for (const auto& [i, stmt_name, query] : prepares)
+          {
+            if (i < results.size() && PQresultStatus(results[i].native_handle()) == PGRES_FATAL_ERROR)
+            {
+              if (auto it = statements_.find(stmt_name); it != statements_.end() && it->second == query)
+                statements_.erase(it);
+            }
+          }
+
+          if (!results.empty())
+            ec = {};
+
+          PSQL_PROBE(acquire__done, this, ec.value());
           lg.unlock();
           return self.complete(ec, { this->weak_from_this(), std::move(*conn) });
         }
@@ -160,6 +250,8 @@ public:
     aquired_conns_--;
     cv_.cancel_one();
 
+    PSQL_PROBE(release, this, conn.native_handle(), aquired_conns_);
+
     if (PQstatus(conn.native_handle()) != CONNECTION_OK)
       return;
 
@@ -168,6 +260,7 @@ public:
 
     idle_conns_.push(std::move(conn));
   }
+
 };
 } // namespace detail
 
@@ -188,13 +281,24 @@ public:
   using executor_type = Executor;
 
   basic_connection_pool(Executor exec, std::string conninfo, size_t max_size = 32)
-    : impl_{ std::make_shared<impl_type>(std::move(exec), std::move(conninfo), max_size) }
+    : basic_connection_pool{ std::move(exec), std::move(conninfo), connect_options{}, max_size }
+  {
+  }
+
+  basic_connection_pool(Executor exec, std::string conninfo, connect_options options, size_t max_size = 32)
+    : impl_{ std::make_shared<impl_type>(std::move(exec), std::move(conninfo), std::move(options), max_size) }
   {
   }
 
   template<typename ExecutionContext>
   basic_connection_pool(ExecutionContext& context, std::string conninfo, size_t max_size = 32)
-    : impl_{ std::make_shared<impl_type>(context.get_executor(), std::move(conninfo), max_size) }
+    : basic_connection_pool{ context.get_executor(), std::move(conninfo), connect_options{}, max_size }
+  {
+  }
+
+  template<typename ExecutionContext>
+  basic_connection_pool(ExecutionContext& context, std::string conninfo, connect_options options, size_t max_size = 32)
+    : impl_{ std::make_shared<impl_type>(context.get_executor(), std::move(conninfo), std::move(options), max_size) }
   {
   }
 
@@ -224,6 +328,26 @@ public:
     return impl_->num_aquired();
   }
 
+  // Registers a statement that is prepared on every connection of the pool before it is handed out, so
+  // async_query_prepared can be used on any pooled connection. Registering a name again with another query replaces the
+  // statement on each connection. A statement that fails to prepare (e.g. invalid SQL or a dropped table) is
+  // unregistered, and the connection is handed out without it; see is_registered.
+  void register_statement(std::string stmt_name, std::string query)
+  {
+    impl_->register_statement(std::move(stmt_name), std::move(query));
+  }
+
+  // Stops preparing the statement on connections. Connections that have already prepared it keep it.
+  void unregister_statement(std::string_view stmt_name)
+  {
+    impl_->unregister_statement(stmt_name);
+  }
+
+  bool is_registered(std::string_view stmt_name) const
+  {
+    return impl_->is_registered(stmt_name);
+  }
+
   template<typename CompletionToken = asio::default_completion_token_t<executor_type>>
   auto async_aquire(CompletionToken&& token = CompletionToken{})
   {
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace psql
+{
+// A timestamp with time zone. It is an absolute point in time, and the session time zone only affects its text form.
+struct timestamptz
+{
+  std::chrono::system_clock::time_point time_point;
+
+  friend bool operator==(const timestamptz&, const timestamptz&) = default;
+};
+
+// Months and days are kept apart from the time, because their lengths depend on the date they are added to.
+struct interval
+{
+  std::chrono::microseconds time{};
+  int32_t days{};
+  int32_t months{};
+
+  friend bool operator==(const interval&, const interval&) = default;
+};
+} // namespace psql
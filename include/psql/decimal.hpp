@@ -0,0 +1,49 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace psql
+{
+__extension__ typedef __int128 int128_t;
+__extension__ typedef unsigned __int128 uint128_t;
+
+// Exact value of a numeric column, equal to `value` * 10^-`scale`. Non-finite values and values that don't fit in 128
+// bits can't be decoded into a decimal.
+struct decimal
+{
+  int128_t value{};
+  uint16_t scale{};
+
+  friend bool operator==(const decimal&, const decimal&) = default;
+};
+
+// Text of a numeric column, of any precision and including NaN, Infinity and -Infinity, decoded from the binary value
+// into a string type such as std::string.
+template<typename T = std::string>
+struct numeric_text
+{
+  T value{};
+};
+
+inline std::string to_string(const decimal& decimal)
+{
+  auto magnitude = decimal.value < 0 ? -static_cast<uint128_t>(decimal.value) : static_cast<uint128_t>(decimal.value);
+
+  auto str = std::string{};
+  for (size_t i = 0; magnitude != 0 || i <= decimal.scale; i++)
+  {
+    if (i == decimal.scale && i != 0)
+      str.push_back('.');
+    str.push_back(static_cast<char>('0' + magnitude % 10));
+    magnitude /= 10;
+  }
+
+  if (decimal.value < 0)
+    str.push_back('-');
+
+  std::reverse(str.begin(), str.end());
+  return str;
+}
+} // namespace psql
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <type_traits>
+
+namespace psql
+{
+// Verifies OIDs and member counts, and checks every length read from the received data against its buffer.
+struct hardened_t
+{
+  explicit constexpr hardened_t() = default;
+};
+
+// Skips all verifications, for known schemas received from trusted servers.
+struct trusted_t
+{
+  explicit constexpr trusted_t() = default;
+};
+
+inline constexpr hardened_t hardened{};
+inline constexpr trusted_t trusted{};
+
+namespace detail
+{
+template<typename T>
+concept decode_mode = std::is_same_v<T, hardened_t> || std::is_same_v<T, trusted_t>;
+
+template<typename Mode>
+constexpr bool is_hardened_v = std::is_same_v<Mode, hardened_t>;
+} // namespace detail
+} // namespace psql
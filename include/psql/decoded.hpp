@@ -0,0 +1,81 @@
+#pragma once
+
+#include <psql/result.hpp>
+
+#include <memory>
+
+namespace psql
+{
+// A decoded value that keeps the result it was decoded from alive, so members such as std::string_view can safely
+// point into the result's memory.
+template<typename T>
+class decoded
+{
+  std::shared_ptr<const result> result_;
+  T value_;
+
+public:
+  decoded(std::shared_ptr<const result> result, T value)
+    : result_{ std::move(result) }
+    , value_{ std::move(value) }
+  {
+  }
+
+  const T& operator*() const noexcept
+  {
+    return value_;
+  }
+
+  const T* operator->() const noexcept
+  {
+    return &value_;
+  }
+
+  const T& value() const noexcept
+  {
+    return value_;
+  }
+
+  const std::shared_ptr<const result>& owner() const noexcept
+  {
+    return result_;
+  }
+};
+
+// Decodes the first row like try_as.
+template<typename... Ts, detail::decode_mode Mode = hardened_t>
+auto try_as_decoded(std::shared_ptr<const result> result, Mode mode = Mode{})
+  -> boost::system::result<decoded<std::remove_cvref_t<decltype(*try_as<Ts...>(*result, mode))>>>
+{
+  auto value = try_as<Ts...>(*result, mode);
+
+  if (!value)
+    return value.error();
+
+  return decoded{ std::move(result), std::move(*value) };
+}
+
+template<typename... Ts, detail::decode_mode Mode = hardened_t>
+auto try_as_decoded(result&& result, Mode mode = Mode{})
+{
+  return try_as_decoded<Ts...>(std::make_shared<const psql::result>(std::move(result)), mode);
+}
+
+// Decodes every row of the result into an element of the vector, like decode_into.
+template<typename T, detail::decode_mode Mode = hardened_t>
+boost::system::result<decoded<std::vector<T>>> try_decode_rows(std::shared_ptr<const result> result, Mode mode = Mode{})
+{
+  auto rows = std::vector<T>{};
+
+  if (auto ec = decode_into(*result, rows, mode))
+    return ec;
+
+  return decoded{ std::move(result), std::move(rows) };
+}
+
+template<typename T, detail::decode_mode Mode = hardened_t>
+auto try_decode_rows(result&& result, Mode mode = Mode{})
+{
+  return try_decode_rows<T>(std::make_shared<const psql::result>(std::move(result)), mode);
+}
+} // namespace psql
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <psql/datetime.hpp>
+#include <psql/decimal.hpp>
 #include <psql/detail/oid_pair.hpp>
+#include <psql/detail/type_traits.hpp>
+#include <psql/json.hpp>
+#include <psql/uuid.hpp>
 
 #include <chrono>
 #include <cstdint>
@@ -32,6 +37,13 @@ struct builtin<std::byte>
   static constexpr oid_pair oids{ 17, 1001 };
 };
 
+template<typename T>
+  requires(is_bytea_v<T>)
+struct builtin<T>
+{
+  static constexpr oid_pair oids{ 17, 1001 };
+};
+
 template<>
 struct builtin<char>
 {
@@ -74,14 +86,74 @@ struct builtin<std::chrono::system_clock::time_point>
   static constexpr oid_pair oids{ 1114, 1115 };
 };
 
+template<>
+struct builtin<timestamptz>
+{
+  static constexpr oid_pair oids{ 1184, 1185 };
+};
+
+template<>
+struct builtin<std::chrono::sys_days>
+{
+  static constexpr oid_pair oids{ 1082, 1182 };
+};
+
+template<>
+struct builtin<std::chrono::year_month_day>
+{
+  static constexpr oid_pair oids{ 1082, 1182 };
+};
+
+template<>
+struct builtin<std::chrono::hh_mm_ss<std::chrono::microseconds>>
+{
+  static constexpr oid_pair oids{ 1083, 1183 };
+};
+
+template<>
+struct builtin<interval>
+{
+  static constexpr oid_pair oids{ 1186, 1187 };
+};
+
+template<>
+struct builtin<uuid>
+{
+  static constexpr oid_pair oids{ 2950, 2951 };
+};
+
+template<typename T>
+struct builtin<json<T>>
+{
+  static constexpr oid_pair oids{ 114, 199 };
+};
+
+template<typename T>
+struct builtin<jsonb<T>>
+{
+  static constexpr oid_pair oids{ 3802, 3807 };
+};
+
+template<>
+struct builtin<decimal>
+{
+  static constexpr oid_pair oids{ 1700, 1231 };
+};
+
+template<typename T>
+struct builtin<numeric_text<T>>
+{
+  static constexpr oid_pair oids{ 1700, 1231 };
+};
+
 template<>
 struct builtin<std::string_view>
 {
   static constexpr oid_pair oids{ 25, 1009 };
 };
 
-template<>
-struct builtin<std::string>
+template<typename Traits, typename Allocator>
+struct builtin<std::basic_string<char, Traits, Allocator>>
 {
   static constexpr oid_pair oids{ 25, 1009 };
 };
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <libpq-fe.h>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace psql
+{
+namespace detail
+{
+struct connect_target
+{
+  std::string host;
+  std::string hostaddr;
+  std::string port;
+
+  // Empty hosts and Unix-domain socket paths are left to libpq.
+  bool needs_resolution() const noexcept
+  {
+    return hostaddr.empty() && !host.empty() && host.front() != '/' && host.front() != '@';
+  }
+};
+
+class conninfo
+{
+  struct pqconninfooption_deleter
+  {
+    void operator()(PQconninfoOption* p)
+    {
+      PQconninfoFree(p);
+    }
+  };
+
+  std::vector<std::pair<std::string, std::string>> options_;
+  std::vector<connect_target> targets_;
+  std::string port_;
+  bool whole_list_ = false;
+
+  static std::vector<std::string> split(std::string_view list)
+  {
+    auto items = std::vector<std::string>{};
+    for (auto pos = list.find(','); !list.empty(); pos = list.find(','))
+    {
+      items.emplace_back(list.substr(0, pos));
+      list.remove_prefix(pos == std::string_view::npos ? list.size() : pos + 1);
+    }
+    return items;
+  }
+
+  template<typename Projection>
+  static std::string join(const std::vector<connect_target>& targets, Projection projection)
+  {
+    auto list = std::string{};
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+      if (i != 0)
+        list.push_back(',');
+      list.append(targets[i].*projection);
+    }
+    return list;
+  }
+
+public:
+  // Returns false if the connection string is invalid.
+  bool parse(const std::string& conninfo)
+  {
+    auto options = std::unique_ptr<PQconninfoOption, pqconninfooption_deleter>{
+      PQconninfoParse(conninfo.data(), nullptr)
+    };
+
+    if (!options)
+      return false;
+
+    auto hosts     = std::vector<std::string>{};
+    auto hostaddrs = std::vector<std::string>{};
+    auto ports     = std::vector<std::string>{};
+    auto service   = false;
+
+    for (auto* option = options.get(); option->keyword; option++)
+    {
+      if (!option->val)
+        continue;
+
+      if (std::string_view{ option->keyword } == "host")
+        hosts = split(option->val);
+      else if (std::string_view{ option->keyword } == "hostaddr")
+        hostaddrs = split(option->val);
+      else if (std::string_view{ option->keyword } == "port")
+        ports = split(port_ = option->val);
+      else
+        options_.emplace_back(option->keyword, option->val);
+
+      service |= std::string_view{ option->keyword } == "service";
+    }
+
+    // PQconninfoParse doesn't apply the defaults from the environment (PGHOST, PGHOSTADDR, PGPORT and PGSERVICE), so
+    // the hosts are taken from PQconndefaults when the connection string has none. A service named in the connection
+    // string takes precedence over the environment, but libpq can't expand it without connecting, so its hosts are
+    // left to libpq.
+    if (hosts.empty() && hostaddrs.empty() && !service)
+    {
+      auto defaults = std::unique_ptr<PQconninfoOption, pqconninfooption_deleter>{ PQconndefaults() };
+
+      for (auto* option = defaults.get(); option && option->keyword; option++)
+      {
+        if (!option->val)
+          continue;
+
+        if (std::string_view{ option->keyword } == "host")
+          hosts = split(option->val);
+        else if (std::string_view{ option->keyword } == "hostaddr")
+          hostaddrs = split(option->val);
+        else if (std::string_view{ option->keyword } == "port" && ports.empty())
+          ports = split(port_ = option->val);
+      }
+    }
+
+    // With these options libpq chooses among all the hosts, so they can't be tried in separate attempts.
+    const auto whole_list = [](std::string_view keyword, std::string_view value)
+    {
+      return (keyword == "target_session_attrs" && value == "prefer-standby") ||
+             (keyword == "load_balance_hosts" && value != "disable");
+    };
+
+    auto whole_list_keywords = std::vector<std::string_view>{ "target_session_attrs", "load_balance_hosts" };
+    for (const auto& [keyword, value] : options_)
+    {
+      whole_list_ |= whole_list(keyword, value);
+      std::erase(whole_list_keywords, keyword);
+    }
+
+    // Options missing from the connection string are taken from the environment by libpq.
+    if (!whole_list_ && !whole_list_keywords.empty())
+    {
+      auto defaults = std::unique_ptr<PQconninfoOption, pqconninfooption_deleter>{ PQconndefaults() };
+
+      for (auto* option = defaults.get(); option && option->keyword; option++)
+      {
+        if (option->val && std::ranges::find(whole_list_keywords, option->keyword) != whole_list_keywords.end())
+          whole_list_ |= whole_list(option->keyword, option->val);
+      }
+    }
+
+    for (size_t i = 0; i < std::max(hosts.size(), hostaddrs.size()); i++)
+    {
+      targets_.push_back({ i < hosts.size() ? hosts[i] : std::string{},
+                           i < hostaddrs.size() ? hostaddrs[i] : std::string{},
+                           ports.size() == 1 ? ports[0] : i < ports.size() ? ports[i] : std::string{} });
+    }
+
+    return true;
+  }
+
+  const std::vector<connect_target>& targets() const noexcept
+  {
+    return targets_;
+  }
+
+  // True when the targets must be passed to libpq in a single attempt, as `target_session_attrs=prefer-standby` and
+  // `load_balance_hosts=random` choose among all the hosts.
+  bool whole_list() const noexcept
+  {
+    return whole_list_;
+  }
+
+  // Starts a connection to the given targets, which replace the hosts of the connection string. libpq tries them in
+  // order, so passing resolved addresses in `hostaddr` avoids the blocking name resolution in PQconnectStart.
+  PGconn* connect_start(const std::vector<connect_target>& targets) const
+  {
+    auto host     = join(targets, &connect_target::host);
+    auto hostaddr = join(targets, &connect_target::hostaddr);
+    auto port     = targets.empty() ? port_ : join(targets, &connect_target::port);
+
+    auto keywords = std::vector<const char*>{};
+    auto values   = std::vector<const char*>{};
+
+    for (const auto& [keyword, value] : options_)
+    {
+      keywords.push_back(keyword.data());
+      values.push_back(value.data());
+    }
+
+    if (!targets.empty())
+    {
+      keywords.push_back("host");
+      values.push_back(host.data());
+    }
+
+    if (hostaddr.find_first_not_of(',') != std::string::npos)
+    {
+      keywords.push_back("hostaddr");
+      values.push_back(hostaddr.data());
+    }
+
+    if (!port.empty())
+    {
+      keywords.push_back("port");
+      values.push_back(port.data());
+    }
+
+    keywords.push_back(nullptr);
+    values.push_back(nullptr);
+
+    return PQconnectStartParams(keywords.data(), values.data(), 0);
+  }
+};
+} // namespace detail
+} // namespace psql
@@ -1,10 +1,18 @@
 #pragma once
 
+#include <psql/decode_mode.hpp>
+#include <psql/detail/numeric.hpp>
 #include <psql/detail/oid_of.hpp>
 #include <psql/detail/size_of.hpp>
+#include <psql/error.hpp>
 
 #include <boost/endian.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <memory>
 #include <span>
 
 namespace psql
@@ -14,135 +22,645 @@ namespace detail
 template<class T>
 struct deserialize_impl;
 
-template<typename T>
-void deserialize(std::span<const char> buffer, T& v)
+template<typename T, typename Mode = hardened_t>
+boost::system::error_code deserialize(std::span<const char> buffer, T& v, Mode mode = Mode{})
 {
-  deserialize_impl<std::decay_t<T>>::apply(buffer, v);
+  return deserialize_impl<std::decay_t<T>>::apply(buffer, v, mode);
 }
 
 template<typename T>
   requires(std::is_integral_v<T> || std::is_floating_point_v<T> || std::is_same_v<T, std::byte>)
 struct deserialize_impl<T>
 {
-  static void apply(std::span<const char> buffer, T& value)
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, T& value, Mode)
   {
+    if (is_hardened_v<Mode> && buffer.size() < sizeof(T))
+      return error::unexpected_data_size;
+
     value = boost::endian::endian_load<T, sizeof(T), boost::endian::order::big>(
       reinterpret_cast<const unsigned char*>(buffer.data()));
+    return {};
   }
 };
 
 template<>
 struct deserialize_impl<std::chrono::system_clock::time_point>
 {
-  static void apply(std::span<const char> buffer, std::chrono::system_clock::time_point& value)
+  template<typename Mode>
+  static boost::system::error_code apply(
+    std::span<const char> buffer,
+    std::chrono::system_clock::time_point& value,
+    Mode mode)
   {
     int64_t int_value{};
-    deserialize(buffer, int_value);
+    if (auto ec = deserialize(buffer, int_value, mode))
+      return ec;
+
+    // infinity and -infinity are clamped to the range of the time point in trusted mode.
+    if (int_value == std::numeric_limits<int64_t>::max() || int_value == std::numeric_limits<int64_t>::min())
+    {
+      if (is_hardened_v<Mode>)
+        return error::infinite_value;
+
+      using time_point = std::chrono::system_clock::time_point;
+      value            = int_value > 0 ? time_point::max() : time_point::min();
+      return {};
+    }
+
     value = std::chrono::system_clock::time_point{} + std::chrono::microseconds{ int_value + 946684800000000 };
+    return {};
+  }
+};
+
+// Decodes non-NULL values, reusing the contained value when there is one.
+template<typename T>
+struct deserialize_impl<std::optional<T>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, std::optional<T>& value, Mode mode)
+  {
+    return deserialize(buffer, value ? *value : value.emplace(), mode);
+  }
+};
+
+template<typename T, typename Mode>
+boost::system::error_code deserialize_json_text(std::span<const char> buffer, T& value, Mode mode)
+{
+  if constexpr (is_string_like_v<T>)
+    return deserialize(buffer, value, mode);
+  else
+    return json_traits<T>::parse(std::string_view{ buffer.data(), buffer.size() }, value);
+}
+
+template<typename T>
+struct deserialize_impl<json<T>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, json<T>& value, Mode mode)
+  {
+    return deserialize_json_text(buffer, value.value, mode);
+  }
+};
+
+template<typename T>
+struct deserialize_impl<jsonb<T>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, jsonb<T>& value, Mode mode)
+  {
+    if (is_hardened_v<Mode> && (buffer.empty() || buffer.front() != 1))
+      return error::unexpected_jsonb_version;
+
+    return deserialize_json_text(buffer.subspan(1), value.value, mode);
+  }
+};
+
+template<typename T>
+  requires(is_user_defined_enum_v<T>)
+struct deserialize_impl<T>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, T& value, Mode)
+  {
+    if (!enum_table<T>::value({ buffer.data(), buffer.size() }, value))
+      return error::unexpected_enum_label;
+    return {};
+  }
+};
+
+template<>
+struct deserialize_impl<timestamptz>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, timestamptz& value, Mode mode)
+  {
+    return deserialize(buffer, value.time_point, mode);
+  }
+};
+
+template<>
+struct deserialize_impl<std::chrono::sys_days>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, std::chrono::sys_days& value, Mode mode)
+  {
+    int32_t int_value{};
+    if (auto ec = deserialize(buffer, int_value, mode))
+      return ec;
+
+    // infinity and -infinity are clamped to the first and last day of the range of std::chrono::year in trusted mode.
+    if (int_value == std::numeric_limits<int32_t>::max() || int_value == std::numeric_limits<int32_t>::min())
+    {
+      if (is_hardened_v<Mode>)
+        return error::infinite_value;
+
+      value = int_value > 0 ? std::chrono::sys_days{ std::chrono::year::max() / 12 / 31 }
+                            : std::chrono::sys_days{ std::chrono::year::min() / 1 / 1 };
+      return {};
+    }
+
+    value = std::chrono::sys_days{ std::chrono::year{ 2000 } / 1 / 1 } + std::chrono::days{ int_value };
+    return {};
+  }
+};
+
+template<>
+struct deserialize_impl<std::chrono::year_month_day>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, std::chrono::year_month_day& value, Mode mode)
+  {
+    auto days = std::chrono::sys_days{};
+    if (auto ec = deserialize(buffer, days, mode))
+      return ec;
+    value = days;
+    return {};
+  }
+};
+
+template<>
+struct deserialize_impl<std::chrono::hh_mm_ss<std::chrono::microseconds>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(
+    std::span<const char> buffer,
+    std::chrono::hh_mm_ss<std::chrono::microseconds>& value,
+    Mode mode)
+  {
+    int64_t int_value{};
+    if (auto ec = deserialize(buffer, int_value, mode))
+      return ec;
+    value = std::chrono::hh_mm_ss{ std::chrono::microseconds{ int_value } };
+    return {};
+  }
+};
+
+template<>
+struct deserialize_impl<interval>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, interval& value, Mode mode)
+  {
+    if (is_hardened_v<Mode> && buffer.size() < 16)
+      return error::unexpected_data_size;
+
+    int64_t time{};
+    deserialize(buffer.subspan(0), time, mode);
+    deserialize(buffer.subspan(8), value.days, mode);
+    deserialize(buffer.subspan(12), value.months, mode);
+    value.time = std::chrono::microseconds{ time };
+    return {};
+  }
+};
+
+template<>
+struct deserialize_impl<uuid>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, uuid& value, Mode)
+  {
+    if (is_hardened_v<Mode> && buffer.size() < value.bytes.size())
+      return error::unexpected_data_size;
+
+    std::memcpy(value.bytes.data(), buffer.data(), value.bytes.size());
+    return {};
+  }
+};
+
+// Reads the numeric header, and verifies that the digits fit in the buffer.
+template<typename Mode>
+boost::system::error_code deserialize_numeric_header(
+  std::span<const char> buffer,
+  int16_t& ndigits,
+  int16_t& weight,
+  uint16_t& sign,
+  uint16_t& dscale,
+  Mode mode)
+{
+  if (is_hardened_v<Mode> && buffer.size() < 8)
+    return error::unexpected_data_size;
+
+  deserialize(buffer.subspan(0), ndigits, mode);
+  deserialize(buffer.subspan(2), weight, mode);
+  deserialize(buffer.subspan(4), sign, mode);
+  deserialize(buffer.subspan(6), dscale, mode);
+
+  if (is_hardened_v<Mode> && (ndigits < 0 || static_cast<size_t>(ndigits) > (buffer.size() - 8) / 2))
+    return error::unexpected_data_size;
+
+  return {};
+}
+
+template<typename Mode>
+auto numeric_digit_at(std::span<const char> buffer, Mode mode)
+{
+  return [=](int i)
+  {
+    int16_t digit = {};
+    deserialize(buffer.subspan(8 + 2 * i), digit, mode);
+    return digit;
+  };
+}
+
+template<>
+struct deserialize_impl<decimal>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, decimal& value, Mode mode)
+  {
+    int16_t ndigits = {};
+    int16_t weight  = {};
+    uint16_t sign   = {};
+    uint16_t dscale = {};
+    if (auto ec = deserialize_numeric_header(buffer, ndigits, weight, sign, dscale, mode))
+      return ec;
+
+    if ((sign != numeric::positive && sign != numeric::negative) ||
+        !from_numeric_digits(numeric_digit_at(buffer, mode), ndigits, weight, sign, dscale, value))
+      return error::numeric_out_of_range;
+
+    return {};
+  }
+};
+
+template<typename T>
+struct deserialize_impl<numeric_text<T>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, numeric_text<T>& value, Mode mode)
+  {
+    int16_t ndigits = {};
+    int16_t weight  = {};
+    uint16_t sign   = {};
+    uint16_t dscale = {};
+    if (auto ec = deserialize_numeric_header(buffer, ndigits, weight, sign, dscale, mode))
+      return ec;
+
+    if (!format_numeric_digits(numeric_digit_at(buffer, mode), ndigits, weight, sign, dscale, value.value))
+      return error::numeric_out_of_range;
+
+    return {};
   }
 };
 
 template<>
 struct deserialize_impl<std::string_view>
 {
-  static void apply(std::span<const char> buffer, std::string_view& value)
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, std::string_view& value, Mode)
   {
     value = { buffer.begin(), buffer.end() };
+    return {};
+  }
+};
+
+template<typename Traits, typename Allocator>
+struct deserialize_impl<std::basic_string<char, Traits, Allocator>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(
+    std::span<const char> buffer,
+    std::basic_string<char, Traits, Allocator>& value,
+    Mode)
+  {
+    value.assign(buffer.data(), buffer.size());
+    return {};
+  }
+};
+
+template<typename Allocator>
+struct deserialize_impl<std::vector<std::byte, Allocator>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(
+    std::span<const char> buffer,
+    std::vector<std::byte, Allocator>& value,
+    Mode)
+  {
+    const auto* data = reinterpret_cast<const std::byte*>(buffer.data());
+    value.assign(data, data + buffer.size());
+    return {};
   }
 };
 
 template<>
-struct deserialize_impl<std::string>
+struct deserialize_impl<std::span<const std::byte>>
 {
-  static void apply(std::span<const char> buffer, std::string& value)
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, std::span<const std::byte>& value, Mode)
   {
-    value.append(buffer.begin(), buffer.end());
+    value = std::as_bytes(buffer);
+    return {};
   }
 };
 
-inline void deserialize_and_verify_oid(std::span<const char> buffer, uint32_t expected_oid)
+template<typename Mode>
+boost::system::error_code deserialize_and_verify_oid(std::span<const char> buffer, uint32_t expected_oid, Mode mode)
+{
+  if constexpr (is_hardened_v<Mode>)
+  {
+    uint32_t oid = {};
+    if (auto ec = deserialize<uint32_t>(buffer, oid, mode))
+      return ec;
+
+    if (expected_oid != 0 && expected_oid != oid)
+      return error::unexpected_oid;
+  }
+
+  return {};
+}
+
+// Reads a length-prefixed value at `offset`, and consumes the buffer up to its end.
+template<typename T, typename Mode>
+boost::system::error_code deserialize_length_prefixed(std::span<const char>& buffer, size_t offset, T& value, Mode mode)
 {
-  uint32_t oid = {};
-  deserialize<uint32_t>(buffer, oid);
+  int32_t size = {};
+  if (auto ec = deserialize<int32_t>(buffer.subspan(std::min(offset, buffer.size())), size, mode))
+    return ec;
+
+  // NULL values have a -1 length and no data.
+  if (size == -1)
+  {
+    if constexpr (!is_optional_v<T>)
+    {
+      return error::unexpected_null;
+    }
+    else
+    {
+      value.reset();
+      buffer = buffer.subspan(offset + 4);
+      return {};
+    }
+  }
 
-  if (expected_oid != 0 && expected_oid != oid)
-    throw std::runtime_error{ "Mismatched Object Identifiers (OIDs) in received and expected types. Found " +
-                              std::to_string(oid) + " instead of " + std::to_string(expected_oid) };
+  if (is_hardened_v<Mode> && (size < 0 || static_cast<size_t>(size) > buffer.size() - offset - 4))
+    return error::unexpected_data_size;
+
+  if (auto ec = deserialize(buffer.subspan(offset + 4, size), value, mode))
+    return ec;
+
+  buffer = buffer.subspan(offset + 4 + size); // consumes buffer
+  return {};
 }
 
 template<typename T>
   requires(is_composite_v<T>)
 struct deserialize_impl<T>
 {
-  template<typename U>
-  static void deserialize_member(std::span<const char>& buffer, U& value)
+  template<typename U, typename Mode>
+  static boost::system::error_code deserialize_member(std::span<const char>& buffer, U& value, Mode mode)
   {
-    deserialize_and_verify_oid(buffer, oid_of<U>());
-
-    int32_t member_size = {};
-    deserialize<int32_t>(buffer.subspan(4), member_size);
+    if (auto ec = deserialize_and_verify_oid(buffer, oid_of<U>(), mode))
+      return ec;
 
-    deserialize(buffer.subspan(8, member_size), value);
-
-    buffer = buffer.subspan(8 + member_size); // consumes buffer
+    return deserialize_length_prefixed(buffer, 4, value, mode);
   }
 
-  static void verify_member_counts(std::span<const char>& buffer, int32_t expected_count)
+  template<typename Mode>
+  static boost::system::error_code verify_member_counts(
+    std::span<const char>& buffer,
+    int32_t expected_count,
+    Mode mode)
   {
     int32_t count = {};
-    deserialize<int32_t>(buffer, count);
+    if (auto ec = deserialize<int32_t>(buffer, count, mode))
+      return ec;
+
+    if (is_hardened_v<Mode> && expected_count != count)
+      return error::unexpected_member_count;
 
-    if (expected_count != count)
-      throw std::runtime_error{ "Mismatched member counts in received and expected composite types. Found " +
-                                std::to_string(count) + " instead of " + std::to_string(expected_count) };
+    buffer = buffer.subspan(4);
+    return {};
   }
 
-  static void apply(std::span<const char> buffer, T& value)
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, T& value, Mode mode)
     requires(is_user_defined_v<T>)
   {
-    verify_member_counts(buffer, std::tuple_size_v<decltype(user_defined<T>::members)>);
-    buffer = buffer.subspan(4);
-    std::apply([&](auto&&... ms) { (deserialize_member(buffer, value.*ms), ...); }, user_defined<T>::members);
+    if (auto ec = verify_member_counts(buffer, std::tuple_size_v<decltype(user_defined<T>::members)>, mode))
+      return ec;
+
+    auto ec = boost::system::error_code{};
+    std::apply(
+      [&](auto&&... ms) { (!(ec = deserialize_member(buffer, value.*ms, mode)) && ...); }, user_defined<T>::members);
+    return ec;
   }
 
-  static void apply(std::span<const char> buffer, T& value)
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, T& value, Mode mode)
     requires(is_tuple_v<T>)
   {
-    verify_member_counts(buffer, std::tuple_size_v<T>);
-    buffer = buffer.subspan(4);
-    std::apply([&](auto&&... ms) { (deserialize_member(buffer, ms), ...); }, value);
+    if (auto ec = verify_member_counts(buffer, std::tuple_size_v<T>, mode))
+      return ec;
+
+    auto ec = boost::system::error_code{};
+    std::apply([&](auto&&... ms) { (!(ec = deserialize_member(buffer, ms, mode)) && ...); }, value);
+    return ec;
   }
 };
 
+// The maximum number of dimensions of a PostgreSQL array (MAXDIM).
+inline constexpr int32_t max_array_dimensions = 6;
+
+// Reads the dimensions that follow the array header, and consumes the buffer up to the first element. Each element has
+// at least a 4 bytes length, which bounds the element count by the received data.
+template<typename Mode>
+boost::system::error_code deserialize_dimensions(
+  std::span<const char>& buffer,
+  std::span<array_dimension> dimensions,
+  size_t& count,
+  Mode mode)
+{
+  const auto header_size = 12 + 8 * dimensions.size();
+
+  if (is_hardened_v<Mode> && buffer.size() < header_size)
+    return error::unexpected_data_size;
+
+  count = 1;
+  for (size_t i = 0; i < dimensions.size(); i++)
+  {
+    deserialize<int32_t>(buffer.subspan(12 + 8 * i), dimensions[i].size, mode);
+    deserialize<int32_t>(buffer.subspan(16 + 8 * i), dimensions[i].lower_bound, mode);
+
+    if (is_hardened_v<Mode> && dimensions[i].size < 0)
+      return error::unexpected_data_size;
+
+    count *= dimensions[i].size;
+
+    if (is_hardened_v<Mode> && count > (buffer.size() - header_size) / 4)
+      return error::unexpected_data_size;
+  }
+
+  buffer = buffer.subspan(header_size);
+  return {};
+}
+
+// Constructs the allocator-aware members of a user-defined type, including those of nested user-defined types, with the
+// given allocator. Containers pass their allocator on to tuples through uses-allocator construction, but user-defined
+// types are default constructed.
+template<typename T, typename Allocator>
+void construct_members_with_allocator(T& value, const Allocator& allocator)
+{
+  std::apply(
+    [&](auto... ms)
+    {
+      (
+        [&](auto& member)
+        {
+          using member_type = std::remove_cvref_t<decltype(member)>;
+          if constexpr (std::uses_allocator_v<member_type, Allocator>)
+          {
+            std::destroy_at(&member);
+            std::uninitialized_construct_using_allocator(&member, allocator);
+          }
+          else if constexpr (is_user_defined_v<member_type> && is_composite_v<member_type>)
+          {
+            construct_members_with_allocator(member, allocator);
+          }
+        }(value.*ms),
+        ...);
+    },
+    user_defined<T>::members);
+}
+
+// Resizes resizable containers, and verifies the size of fixed-size ones.
+template<typename T>
+bool resize_array(T& array, size_t size)
+{
+  using value_type = std::ranges::range_value_t<T>;
+
+  if constexpr (requires { array.get_allocator(); } && is_user_defined_v<value_type> && is_composite_v<value_type>)
+  {
+    // New elements are moved into the container, which keeps the allocator of their members.
+    if constexpr (!std::is_same_v<typename T::allocator_type, std::allocator<value_type>>)
+    {
+      if (array.size() > size)
+        array.erase(array.begin() + size, array.end());
+
+      while (array.size() < size)
+      {
+        auto value = value_type{};
+        construct_members_with_allocator(value, array.get_allocator());
+        array.push_back(std::move(value));
+      }
+
+      return true;
+    }
+  }
+
+  if constexpr (requires { array.resize(size); })
+  {
+    array.resize(size);
+    return true;
+  }
+  else
+  {
+    return std::ranges::size(array) == size;
+  }
+}
+
 template<typename T>
   requires(is_array_v<T>)
 struct deserialize_impl<T>
 {
-  using value_type = std::decay_t<typename T::value_type>;
+  static constexpr auto rank = array_rank_v<T>;
+
+  template<typename U, typename Mode>
+  static boost::system::error_code deserialize_elements(
+    std::span<const char>& buffer,
+    const array_dimension* dimension,
+    U& array,
+    Mode mode)
+  {
+    if (!resize_array(array, dimension->size))
+      return error::unexpected_array_dimensions;
+
+    for (auto& value : array)
+    {
+      if constexpr (is_array_v<std::ranges::range_value_t<U>>)
+      {
+        if (auto ec = deserialize_elements(buffer, dimension + 1, value, mode))
+          return ec;
+      }
+      else
+      {
+        if (auto ec = deserialize_length_prefixed(buffer, 0, value, mode))
+          return ec;
+      }
+    }
 
-  static void apply(std::span<const char> buffer, T& array)
+    return {};
+  }
+
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, T& array, Mode mode)
   {
+    if (is_hardened_v<Mode> && buffer.size() < 12)
+      return error::unexpected_data_size;
+
     int32_t dimensions_count = {};
-    deserialize<int32_t>(buffer.subspan(0), dimensions_count);
+    deserialize<int32_t>(buffer.subspan(0), dimensions_count, mode);
 
-    if (dimensions_count != 1)
-      throw std::runtime_error{ "Unexpected multidimensional array" };
+    // Empty arrays have no dimensions.
+    if (dimensions_count == 0)
+      return resize_array(array, 0) ? boost::system::error_code{} : error::unexpected_array_dimensions;
 
-    deserialize_and_verify_oid(buffer.subspan(8), oid_of<value_type>());
+    if (dimensions_count != rank)
+      return error::unexpected_array_dimensions;
 
-    int32_t size = {};
-    deserialize<int32_t>(buffer.subspan(12), size);
+    if (auto ec = deserialize_and_verify_oid(buffer.subspan(8), oid_of<array_element_t<T>>(), mode))
+      return ec;
 
-    buffer = buffer.subspan(20);
-    array.resize(size);
+    auto dimensions = std::array<array_dimension, rank>{};
+    auto count      = size_t{};
+    if (auto ec = deserialize_dimensions(buffer, dimensions, count, mode))
+      return ec;
 
-    for (auto& value : array)
+    return deserialize_elements(buffer, dimensions.data(), array, mode);
+  }
+};
+
+template<typename T, typename Allocator>
+struct deserialize_impl<md_array<T, Allocator>>
+{
+  template<typename Mode>
+  static boost::system::error_code apply(std::span<const char> buffer, md_array<T, Allocator>& array, Mode mode)
+  {
+    if (is_hardened_v<Mode> && buffer.size() < 12)
+      return error::unexpected_data_size;
+
+    int32_t dimensions_count = {};
+    deserialize<int32_t>(buffer.subspan(0), dimensions_count, mode);
+
+    if (is_hardened_v<Mode> && (dimensions_count < 0 || buffer.size() < 12 + 8 * static_cast<size_t>(dimensions_count)))
+      return error::unexpected_data_size;
+
+    // Checked before allocating the dimensions, the server never sends more than MAXDIM.
+    if (dimensions_count < 0 || dimensions_count > max_array_dimensions)
+      return error::unexpected_array_dimensions;
+
+    if (dimensions_count != 0)
+    {
+      if (auto ec = deserialize_and_verify_oid(buffer.subspan(8), oid_of<T>(), mode))
+        return ec;
+    }
+
+    array.dimensions.resize(dimensions_count);
+
+    auto count = size_t{};
+    if (auto ec = deserialize_dimensions(buffer, array.dimensions, count, mode))
+      return ec;
+
+    array.values.resize(dimensions_count == 0 ? 0 : count);
+
+    for (auto& value : array.values)
     {
-      int32_t value_size = {};
-      deserialize<int32_t>(buffer, value_size);
-      deserialize(buffer.subspan(4, value_size), value);
-      buffer = buffer.subspan(4 + value_size); // consumes buffer
+      if (auto ec = deserialize_length_prefixed(buffer, 0, value, mode))
+        return ec;
     }
+
+    return {};
   }
 };
 } // namespace detail
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <psql/detail/type_traits.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace psql
+{
+namespace detail
+{
+// Compile-time label tables of a user-defined enum. Values are encoded through a table indexed by the enumerator
+// values when they are dense enough, and labels are decoded through a binary search of the sorted labels.
+template<typename T>
+class enum_table
+{
+  static constexpr auto& enumerators = user_defined<T>::enumerators;
+
+  static_assert(!enumerators.empty());
+
+  static constexpr auto by_label = []
+  {
+    auto sorted = std::array<enumerator<T>, enumerators.size()>{};
+    std::ranges::copy(enumerators, sorted.begin());
+    std::ranges::sort(sorted, {}, &enumerator<T>::label);
+    return sorted;
+  }();
+
+  // An empty label marks a value without an enumerator.
+  static constexpr bool distinct = []
+  {
+    auto values = std::array<T, enumerators.size()>{};
+    std::ranges::transform(enumerators, values.begin(), &enumerator<T>::value);
+    std::ranges::sort(values);
+
+    return !by_label.front().label.empty() &&
+           std::ranges::adjacent_find(by_label, {}, &enumerator<T>::label) == by_label.end() &&
+           std::ranges::adjacent_find(values) == values.end();
+  }();
+
+  static_assert(distinct, "Enumerators must have distinct values and distinct non-empty labels");
+
+  static constexpr auto min = std::ranges::min(enumerators, {}, [](const auto& e) { return e.value; }).value;
+  static constexpr auto max = std::ranges::max(enumerators, {}, [](const auto& e) { return e.value; }).value;
+
+  static constexpr auto span = static_cast<int64_t>(max) - static_cast<int64_t>(min) + 1;
+  static constexpr bool dense = span <= 4 * static_cast<int64_t>(enumerators.size()) + 16;
+
+  static constexpr auto labels = []
+  {
+    auto labels = std::array<std::string_view, dense ? span : 0>{};
+    if constexpr (dense)
+    {
+      for (const auto& e : enumerators)
+        labels[static_cast<int64_t>(e.value) - static_cast<int64_t>(min)] = e.label;
+    }
+    return labels;
+  }();
+
+public:
+  // Returns an empty label for values without an enumerator.
+  static constexpr std::string_view label(T value) noexcept
+  {
+    if constexpr (dense)
+    {
+      const auto index = static_cast<int64_t>(value) - static_cast<int64_t>(min);
+      return index >= 0 && index < span ? labels[index] : std::string_view{};
+    }
+    else
+    {
+      const auto it = std::ranges::find(enumerators, value, [](const auto& e) { return e.value; });
+      return it != enumerators.end() ? it->label : std::string_view{};
+    }
+  }
+
+  // Returns false for labels without an enumerator.
+  static constexpr bool value(std::string_view label, T& value) noexcept
+  {
+    const auto it = std::ranges::lower_bound(by_label, label, {}, &enumerator<T>::label);
+    if (it == by_label.end() || it->label != label)
+      return false;
+
+    value = it->value;
+    return true;
+  }
+};
+} // namespace detail
+} // namespace psql
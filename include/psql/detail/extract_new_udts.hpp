@@ -4,6 +4,8 @@
 #include <psql/detail/type_traits.hpp>
 #include <psql/detail/udt_pair.hpp>
 
+#include <vector>
+
 namespace psql
 {
 namespace detail
@@ -22,13 +24,42 @@ void constexpr extract_new_udts(std::vector<udt_pair>& new_udts, const detail::o
   return extract_new_udts_impl<std::decay_t<T>>::apply(new_udts, omp);
 }
 
+template<typename T>
+struct extract_new_udts_impl<std::optional<T>>
+{
+  static constexpr void apply(std::vector<udt_pair>& new_udts, const detail::oid_map& omp)
+  {
+    extract_new_udts<T>(new_udts, omp);
+  }
+};
+
+template<typename T>
+  requires(is_user_defined_enum_v<T>)
+struct extract_new_udts_impl<T>
+{
+  static constexpr void apply(std::vector<udt_pair>& new_udts, const detail::oid_map& omp)
+  {
+    if (!omp.contains(typeid(T)))
+      new_udts.push_back({ user_defined<T>::name, typeid(T) });
+  }
+};
+
+template<typename T, typename Allocator>
+struct extract_new_udts_impl<md_array<T, Allocator>>
+{
+  static constexpr void apply(std::vector<udt_pair>& new_udts, const detail::oid_map& omp)
+  {
+    extract_new_udts<T>(new_udts, omp);
+  }
+};
+
 template<typename T>
   requires(is_array_v<T>)
 struct extract_new_udts_impl<T>
 {
   static constexpr void apply(std::vector<udt_pair>& new_udts, const detail::oid_map& omp)
   {
-    extract_new_udts<typename T::value_type>(new_udts, omp);
+    extract_new_udts<std::ranges::range_value_t<T>>(new_udts, omp);
   }
 };
 
@@ -0,0 +1,219 @@
+#pragma once
+
+#include <psql/decimal.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace psql
+{
+namespace detail
+{
+// Binary numeric layout: the value is the sum of `digits[i]` * 10000^(`weight` - i).
+struct numeric
+{
+  static constexpr uint16_t positive          = 0x0000;
+  static constexpr uint16_t negative          = 0x4000;
+  static constexpr uint16_t nan               = 0xC000;
+  static constexpr uint16_t positive_infinity = 0xD000;
+  static constexpr uint16_t negative_infinity = 0xF000;
+
+  int16_t ndigits{};
+  int16_t weight{};
+  uint16_t sign{};
+  uint16_t dscale{};
+  std::array<int16_t, 11> digits{}; // 128 bits and a padded fractional group
+};
+
+inline constexpr auto powers_of_10 = []
+{
+  auto powers = std::array<uint128_t, 39>{ 1 };
+  for (size_t i = 1; i < powers.size(); i++)
+    powers[i] = powers[i - 1] * 10;
+  return powers;
+}();
+
+template<typename Unsigned>
+constexpr void to_numeric_digits(Unsigned magnitude, numeric& numeric)
+{
+  // Groups are collected from the least significant one, the fractional part is padded to a multiple of 4 digits.
+  auto groups = std::array<int16_t, 11>{};
+  auto count  = 0;
+
+  if (const auto r = numeric.dscale % 4)
+  {
+    groups[count++] = static_cast<int16_t>(magnitude % powers_of_10[r] * powers_of_10[4 - r]);
+    magnitude /= static_cast<Unsigned>(powers_of_10[r]);
+  }
+
+  for (; magnitude != 0; magnitude /= 10000)
+    groups[count++] = static_cast<int16_t>(magnitude % 10000);
+
+  auto lowest = 0;
+  while (lowest < count && groups[lowest] == 0)
+    lowest++;
+
+  numeric.ndigits = static_cast<int16_t>(count - lowest);
+  numeric.weight  = static_cast<int16_t>(count - 1 - (numeric.dscale + 3) / 4);
+  for (auto i = 0; i < numeric.ndigits; i++)
+    numeric.digits[i] = groups[count - 1 - i];
+}
+
+constexpr numeric to_numeric(const decimal& decimal)
+{
+  auto numeric   = detail::numeric{};
+  numeric.sign   = decimal.value < 0 ? numeric::negative : numeric::positive;
+  numeric.dscale = decimal.scale;
+
+  const auto magnitude =
+    decimal.value < 0 ? -static_cast<uint128_t>(decimal.value) : static_cast<uint128_t>(decimal.value);
+
+  if (magnitude == 0)
+    numeric.weight = 0;
+  else if (magnitude <= std::numeric_limits<uint64_t>::max())
+    to_numeric_digits(static_cast<uint64_t>(magnitude), numeric);
+  else
+    to_numeric_digits(magnitude, numeric);
+
+  return numeric;
+}
+
+// Returns false if the value doesn't fit in a decimal.
+template<typename DigitAt>
+bool from_numeric_digits(
+  const DigitAt& digit_at,
+  int16_t ndigits,
+  int16_t weight,
+  uint16_t sign,
+  uint16_t dscale,
+  decimal& decimal)
+{
+  auto magnitude = uint128_t{};
+
+  // The last group is padded with zeros below the scale, which are dropped before they can overflow the magnitude.
+  const auto exponent = 4 * (weight - ndigits + 1) + dscale;
+  const auto padding  = std::clamp(-exponent, 0, 3);
+  const auto base     = [&](int i) -> uint64_t { return i + 1 == ndigits ? powers_of_10[4 - padding] : 10000; };
+  const auto digit    = [&](int i) -> uint64_t
+  {
+    return static_cast<uint16_t>(digit_at(i)) / (i + 1 == ndigits ? powers_of_10[padding] : 1);
+  };
+
+  if (ndigits <= 4)
+  {
+    auto value = uint64_t{};
+    for (auto i = 0; i < ndigits; i++)
+      value = value * base(i) + digit(i);
+    magnitude = value;
+  }
+  else
+  {
+    for (auto i = 0; i < ndigits; i++)
+    {
+      if (__builtin_mul_overflow(magnitude, base(i), &magnitude) ||
+          __builtin_add_overflow(magnitude, digit(i), &magnitude))
+        return false;
+    }
+  }
+
+  if (const auto remaining = exponent + padding; remaining >= 0)
+  {
+    if (magnitude != 0 &&
+        (remaining >= static_cast<int>(powers_of_10.size()) ||
+         __builtin_mul_overflow(magnitude, powers_of_10[remaining], &magnitude)))
+      return false;
+  }
+  else
+  {
+    magnitude = -remaining < static_cast<int>(powers_of_10.size()) ? magnitude / powers_of_10[-remaining] : 0;
+  }
+
+  const auto max = ~uint128_t{} >> 1;
+  if (magnitude > max + (sign == numeric::negative))
+    return false;
+
+  decimal.value = sign == numeric::negative ? static_cast<int128_t>(-magnitude) : static_cast<int128_t>(magnitude);
+  decimal.scale = dscale;
+  return true;
+}
+
+// Formats the value like PostgreSQL does, with `dscale` fractional digits. Returns false if the sign or a digit is
+// invalid.
+template<typename DigitAt, typename String>
+bool format_numeric_digits(
+  const DigitAt& digit_at,
+  int16_t ndigits,
+  int16_t weight,
+  uint16_t sign,
+  uint16_t dscale,
+  String& str)
+{
+  str.clear();
+
+  switch (sign)
+  {
+    case numeric::nan:
+      str.append("NaN");
+      return true;
+    case numeric::positive_infinity:
+      str.append("Infinity");
+      return true;
+    case numeric::negative_infinity:
+      str.append("-Infinity");
+      return true;
+    case numeric::negative:
+      str.push_back('-');
+      break;
+    case numeric::positive:
+      break;
+    default:
+      return false;
+  }
+
+  char group[4];
+  const auto format_group = [&](int i)
+  {
+    const auto digit = i >= 0 && i < ndigits ? digit_at(i) : 0;
+    if (digit < 0 || digit > 9999)
+      return false;
+
+    group[0] = static_cast<char>('0' + digit / 1000);
+    group[1] = static_cast<char>('0' + digit / 100 % 10);
+    group[2] = static_cast<char>('0' + digit / 10 % 10);
+    group[3] = static_cast<char>('0' + digit % 10);
+    return true;
+  };
+
+  if (weight < 0)
+    str.push_back('0');
+
+  for (auto i = 0; i <= weight; i++)
+  {
+    if (!format_group(i))
+      return false;
+
+    // The leading zeros of the first group are dropped.
+    auto skip = 0;
+    while (i == 0 && skip < 3 && group[skip] == '0')
+      skip++;
+
+    str.append(group + skip, 4 - skip);
+  }
+
+  if (dscale > 0)
+    str.push_back('.');
+
+  for (auto i = weight + 1, remaining = static_cast<int>(dscale); remaining > 0; i++, remaining -= 4)
+  {
+    if (!format_group(i))
+      return false;
+
+    str.append(group, std::min(remaining, 4));
+  }
+
+  return true;
+}
+} // namespace detail
+} // namespace psql
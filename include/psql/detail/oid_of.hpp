@@ -11,23 +11,24 @@ namespace detail
 template<class T>
 struct oid_of_impl;
 
+// std::optional has the OID of its value type.
 template<typename T>
 constexpr uint32_t oid_of(const oid_map& omp)
 {
-  return oid_of_impl<std::decay_t<T>>::apply(omp);
+  return oid_of_impl<remove_optional_t<std::decay_t<T>>>::apply(omp);
 }
 
 template<typename T>
 constexpr uint32_t oid_of()
 {
-  return oid_of_impl<std::decay_t<T>>::apply();
+  return oid_of_impl<remove_optional_t<std::decay_t<T>>>::apply();
 }
 
 template<typename T>
-  requires(is_array_v<T>)
+  requires(is_array_v<T> || is_md_array_v<T>)
 struct oid_of_impl<T>
 {
-  using value_type = std::decay_t<typename T::value_type>;
+  using value_type = array_element_t<T>;
 
   static constexpr uint32_t apply(const oid_map&)
     requires(!is_user_defined_v<value_type>)
@@ -55,7 +56,7 @@ struct oid_of_impl<T>
 };
 
 template<typename T>
-  requires(!is_array_v<T>)
+  requires(!is_array_v<T> && !is_md_array_v<T>)
 struct oid_of_impl<T>
 {
   static constexpr uint32_t apply(const oid_map&)
@@ -0,0 +1,17 @@
+#pragma once
+
+// Static tracepoints for tools such as bpftrace and perf, compiled in only when PSQL_ENABLE_USDT is defined. While no
+// tracer is attached a probe costs a nop instruction plus the evaluation of its arguments, which are kept to values at
+// hand such as pointers, sizes and error codes.
+
+#if defined(PSQL_ENABLE_USDT)
+#if !__has_include(<sys/sdt.h>)
+#error "PSQL_ENABLE_USDT requires <sys/sdt.h> from the SystemTap SDT headers"
+#endif
+#include <sys/sdt.h>
+#define PSQL_PROBES_ENABLED 1
+#define PSQL_PROBE(name, ...) STAP_PROBEV(psql, name, __VA_ARGS__)
+#else
+#define PSQL_PROBES_ENABLED 0
+#define PSQL_PROBE(name, ...) ((void)0)
+#endif
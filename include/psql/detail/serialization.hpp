@@ -1,10 +1,13 @@
 #pragma once
 
+#include <psql/detail/numeric.hpp>
 #include <psql/detail/oid_of.hpp>
 #include <psql/detail/size_of.hpp>
+#include <psql/error.hpp>
 #include <psql/params.hpp>
 
 #include <boost/endian.hpp>
+#include <boost/system/system_error.hpp>
 
 #include <array>
 
@@ -23,6 +26,54 @@ const char* serialize(const oid_map& omp, std::string& buffer, const T& v)
   return ret;
 }
 
+// Top-level bytea parameters are passed to libpq straight from the caller's memory, and empty std::optional parameters
+// are passed as null pointers, which libpq sends as NULL.
+template<typename T>
+const char* serialize_param(const oid_map& omp, std::string& buffer, const T& v)
+{
+  if constexpr (is_optional_v<T>)
+  {
+    return v ? serialize_param(omp, buffer, *v) : nullptr;
+  }
+  else
+  {
+    if constexpr (is_bytea_v<T>)
+    {
+      if (!std::ranges::empty(v))
+        return reinterpret_cast<const char*>(std::ranges::data(v));
+    }
+
+    return serialize(omp, buffer, v);
+  }
+}
+
+template<typename T>
+constexpr std::size_t serialized_param_size(const T& v)
+{
+  if constexpr (is_optional_v<T>)
+    return v ? serialized_param_size(*v) : 0;
+  else
+    return is_bytea_v<T> ? 0 : size_of(v);
+}
+
+// Writes the length of the value followed by its data, or a -1 length for NULL.
+template<typename T>
+void serialize_length_prefixed(const oid_map& omp, std::string& buffer, const T& value)
+{
+  if constexpr (is_optional_v<T>)
+  {
+    if (!value)
+      serialize<int32_t>(omp, buffer, -1);
+    else
+      serialize_length_prefixed(omp, buffer, *value);
+  }
+  else
+  {
+    serialize<int32_t>(omp, buffer, size_of(value));
+    serialize(omp, buffer, value);
+  }
+}
+
 template<typename... Ts>
 auto serialize(const oid_map& omp, std::string& buffer, const params<Ts...>& params)
 {
@@ -38,10 +89,10 @@ auto serialize(const oid_map& omp, std::string& buffer, const params<Ts...>& par
     [&](const auto&... args)
     {
       buffer.clear();
-      buffer.reserve((0 + ... + size_of(args)));
+      buffer.reserve((0 + ... + serialized_param_size(args)));
 
       return result_type{ { oid_of<decltype(args)>(omp)... },
-                          { serialize(omp, buffer, args)... },
+                          { serialize_param(omp, buffer, args)... },
                           { static_cast<int>(size_of(args))... },
                           { ((void)args, true)... } };
     },
@@ -72,6 +123,118 @@ struct serialize_impl<std::chrono::system_clock::time_point>
   }
 };
 
+template<>
+struct serialize_impl<timestamptz>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const timestamptz& value)
+  {
+    serialize(omp, buffer, value.time_point);
+  }
+};
+
+template<>
+struct serialize_impl<std::chrono::sys_days>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const std::chrono::sys_days& value)
+  {
+    const int32_t int_value = (value - std::chrono::sys_days{ std::chrono::year{ 2000 } / 1 / 1 }).count();
+    serialize(omp, buffer, int_value);
+  }
+};
+
+template<>
+struct serialize_impl<std::chrono::year_month_day>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const std::chrono::year_month_day& value)
+  {
+    serialize(omp, buffer, std::chrono::sys_days{ value });
+  }
+};
+
+template<>
+struct serialize_impl<std::chrono::hh_mm_ss<std::chrono::microseconds>>
+{
+  static void apply(
+    const oid_map& omp,
+    std::string& buffer,
+    const std::chrono::hh_mm_ss<std::chrono::microseconds>& value)
+  {
+    const int64_t int_value = value.to_duration().count();
+    serialize(omp, buffer, int_value);
+  }
+};
+
+template<>
+struct serialize_impl<interval>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const interval& value)
+  {
+    serialize<int64_t>(omp, buffer, value.time.count());
+    serialize<int32_t>(omp, buffer, value.days);
+    serialize<int32_t>(omp, buffer, value.months);
+  }
+};
+
+template<>
+struct serialize_impl<uuid>
+{
+  static void apply(const oid_map&, std::string& buffer, const uuid& value)
+  {
+    buffer.append(reinterpret_cast<const char*>(value.bytes.data()), value.bytes.size());
+  }
+};
+
+template<typename T>
+  requires(is_string_like_v<T>)
+struct serialize_impl<json<T>>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const json<T>& value)
+  {
+    serialize(omp, buffer, value.value);
+  }
+};
+
+template<typename T>
+  requires(is_string_like_v<T>)
+struct serialize_impl<jsonb<T>>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const jsonb<T>& value)
+  {
+    buffer.push_back(1);
+    serialize(omp, buffer, value.value);
+  }
+};
+
+// Enums are sent as their labels, values without an enumerator are rejected before the parameters are sent.
+template<typename T>
+  requires(is_user_defined_enum_v<T>)
+struct serialize_impl<T>
+{
+  static void apply(const oid_map&, std::string& buffer, const T& value)
+  {
+    const auto label = enum_table<T>::label(value);
+    if (label.empty())
+      throw boost::system::system_error{ error::unexpected_enum_label };
+
+    buffer.append(label);
+  }
+};
+
+template<>
+struct serialize_impl<decimal>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const decimal& value)
+  {
+    const auto numeric = to_numeric(value);
+    serialize(omp, buffer, numeric.ndigits);
+    serialize(omp, buffer, numeric.weight);
+    serialize(omp, buffer, numeric.sign);
+    serialize(omp, buffer, numeric.dscale);
+    for (auto i = 0; i < numeric.ndigits; i++)
+      serialize(omp, buffer, numeric.digits[i]);
+  }
+};
+
 template<>
 struct serialize_impl<const char*>
 {
@@ -90,12 +253,32 @@ struct serialize_impl<std::string_view>
   }
 };
 
-template<>
-struct serialize_impl<std::string>
+template<typename Traits, typename Allocator>
+struct serialize_impl<std::basic_string<char, Traits, Allocator>>
 {
-  static void apply(const oid_map&, std::string& buffer, const std::string& value)
+  static void apply(const oid_map&, std::string& buffer, const std::basic_string<char, Traits, Allocator>& value)
   {
-    buffer.append(value);
+    buffer.append(value.data(), value.size());
+  }
+};
+
+template<typename T>
+struct serialize_impl<std::optional<T>>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const std::optional<T>& value)
+  {
+    if (value)
+      serialize(omp, buffer, *value);
+  }
+};
+
+template<typename T>
+  requires(is_bytea_v<T>)
+struct serialize_impl<T>
+{
+  static void apply(const oid_map&, std::string& buffer, const T& value)
+  {
+    buffer.append(reinterpret_cast<const char*>(std::ranges::data(value)), std::ranges::size(value));
   }
 };
 
@@ -107,8 +290,7 @@ struct serialize_impl<T>
   static void serialize_member(const oid_map& omp, std::string& buffer, const U& value)
   {
     serialize<int32_t>(omp, buffer, oid_of<U>(omp));
-    serialize<int32_t>(omp, buffer, size_of(value));
-    serialize(omp, buffer, value);
+    serialize_length_prefixed(omp, buffer, value);
   }
 
   static void apply(const oid_map& omp, std::string& buffer, const T& value)
@@ -130,21 +312,79 @@ template<typename T>
   requires(is_array_v<T>)
 struct serialize_impl<T>
 {
-  using value_type = std::decay_t<typename T::value_type>;
+  // The dimensions are taken from the first elements of the nested ranges.
+  template<typename U>
+  static void serialize_dimensions(const oid_map& omp, std::string& buffer, const U& array, size_t* sizes)
+  {
+    *sizes = std::ranges::size(array);
+    serialize<int32_t>(omp, buffer, *sizes);
+    serialize<int32_t>(omp, buffer, 1);
+
+    if constexpr (is_array_v<std::ranges::range_value_t<U>>)
+    {
+      if (std::ranges::empty(array))
+        serialize_dimensions(omp, buffer, std::ranges::range_value_t<U>{}, sizes + 1);
+      else
+        serialize_dimensions(omp, buffer, *std::ranges::begin(array), sizes + 1);
+    }
+  }
+
+  // Nested ranges must be rectangular, a range whose size differs from its dimension is rejected before the
+  // parameters are sent.
+  template<typename U>
+  static void serialize_elements(const oid_map& omp, std::string& buffer, const U& array, const size_t* sizes)
+  {
+    if (std::ranges::size(array) != *sizes)
+      throw boost::system::system_error{ error::unexpected_array_dimensions };
+
+    for (const auto& value : array)
+    {
+      if constexpr (is_array_v<std::ranges::range_value_t<U>>)
+        serialize_elements(omp, buffer, value, sizes + 1);
+      else
+        serialize_length_prefixed(omp, buffer, value);
+    }
+  }
 
   static void apply(const oid_map& omp, std::string& buffer, const T& array)
   {
-    serialize<int32_t>(omp, buffer, 1);
+    auto sizes = std::array<size_t, array_rank_v<T>>{};
+    serialize<int32_t>(omp, buffer, array_rank_v<T>);
     serialize<int32_t>(omp, buffer, 0);
-    serialize<int32_t>(omp, buffer, oid_of<value_type>(omp));
-    serialize<int32_t>(omp, buffer, std::size(array));
+    serialize<int32_t>(omp, buffer, oid_of<array_element_t<T>>(omp));
+    serialize_dimensions(omp, buffer, array, sizes.data());
+    serialize_elements(omp, buffer, array, sizes.data());
+  }
+};
+
+template<typename T, typename Allocator>
+struct serialize_impl<md_array<T, Allocator>>
+{
+  static void apply(const oid_map& omp, std::string& buffer, const md_array<T, Allocator>& array)
+  {
+    // The dimensions must describe exactly the values, empty arrays have no dimensions.
+    auto count = size_t{ !array.dimensions.empty() };
+    for (const auto& dimension : array.dimensions)
+    {
+      if (dimension.size < 0 || (count *= dimension.size) > array.values.size())
+        throw boost::system::system_error{ error::unexpected_array_dimensions };
+    }
+
+    if (count != array.values.size())
+      throw boost::system::system_error{ error::unexpected_array_dimensions };
+
+    serialize<int32_t>(omp, buffer, array.dimensions.size());
     serialize<int32_t>(omp, buffer, 0);
+    serialize<int32_t>(omp, buffer, oid_of<T>(omp));
 
-    for (const auto& value : array)
+    for (const auto& dimension : array.dimensions)
     {
-      serialize<int32_t>(omp, buffer, size_of(value));
-      serialize(omp, buffer, value);
+      serialize<int32_t>(omp, buffer, dimension.size);
+      serialize<int32_t>(omp, buffer, dimension.lower_bound);
     }
+
+    for (const auto& value : array.values)
+      serialize_length_prefixed(omp, buffer, value);
   }
 };
 } // namespace detail
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <psql/datetime.hpp>
+#include <psql/detail/enum_table.hpp>
+#include <psql/detail/numeric.hpp>
 #include <psql/detail/type_traits.hpp>
+#include <psql/json.hpp>
+#include <psql/uuid.hpp>
 
 #include <chrono>
 #include <string>
@@ -38,6 +43,100 @@ struct size_of_impl<std::chrono::system_clock::time_point>
   }
 };
 
+template<>
+struct size_of_impl<timestamptz>
+{
+  static constexpr std::size_t apply(const timestamptz&)
+  {
+    return 8;
+  }
+};
+
+template<>
+struct size_of_impl<std::chrono::sys_days>
+{
+  static constexpr std::size_t apply(const std::chrono::sys_days&)
+  {
+    return 4;
+  }
+};
+
+template<>
+struct size_of_impl<std::chrono::year_month_day>
+{
+  static constexpr std::size_t apply(const std::chrono::year_month_day&)
+  {
+    return 4;
+  }
+};
+
+template<>
+struct size_of_impl<std::chrono::hh_mm_ss<std::chrono::microseconds>>
+{
+  static constexpr std::size_t apply(const std::chrono::hh_mm_ss<std::chrono::microseconds>&)
+  {
+    return 8;
+  }
+};
+
+template<>
+struct size_of_impl<interval>
+{
+  static constexpr std::size_t apply(const interval&)
+  {
+    return 16;
+  }
+};
+
+template<>
+struct size_of_impl<uuid>
+{
+  static constexpr std::size_t apply(const uuid&)
+  {
+    return 16;
+  }
+};
+
+template<typename T>
+  requires(is_string_like_v<T>)
+struct size_of_impl<json<T>>
+{
+  static constexpr std::size_t apply(const json<T>& value)
+  {
+    return size_of(value.value);
+  }
+};
+
+// jsonb text is preceded by a format version byte.
+template<typename T>
+  requires(is_string_like_v<T>)
+struct size_of_impl<jsonb<T>>
+{
+  static constexpr std::size_t apply(const jsonb<T>& value)
+  {
+    return 1 + size_of(value.value);
+  }
+};
+
+template<typename T>
+  requires(is_user_defined_enum_v<T>)
+struct size_of_impl<T>
+{
+  static constexpr std::size_t apply(const T& value)
+  {
+    return enum_table<T>::label(value).size();
+  }
+};
+
+template<>
+struct size_of_impl<decimal>
+{
+  static constexpr std::size_t apply(const decimal& value)
+  {
+    return 8 + 2 * to_numeric(value).ndigits;
+  }
+};
+
 template<>
 struct size_of_impl<const char*>
 {
@@ -56,23 +155,66 @@ struct size_of_impl<std::string_view>
   }
 };
 
-template<>
-struct size_of_impl<std::string>
+template<typename Traits, typename Allocator>
+struct size_of_impl<std::basic_string<char, Traits, Allocator>>
 {
-  static constexpr std::size_t apply(const std::string& value)
+  static constexpr std::size_t apply(const std::basic_string<char, Traits, Allocator>& value)
   {
     return value.size();
   }
 };
 
+// NULL values have no data.
+template<typename T>
+struct size_of_impl<std::optional<T>>
+{
+  static constexpr std::size_t apply(const std::optional<T>& value)
+  {
+    return value ? size_of(*value) : 0;
+  }
+};
+
+template<typename T>
+  requires(is_bytea_v<T>)
+struct size_of_impl<T>
+{
+  static constexpr std::size_t apply(const T& value)
+  {
+    return std::ranges::size(value);
+  }
+};
+
 template<typename T>
   requires(is_array_v<T>)
 struct size_of_impl<T>
 {
-  static constexpr std::size_t apply(const T& vec)
+  template<typename U>
+  static constexpr std::size_t elements_size(const U& array)
+  {
+    std::size_t size = 0;
+    for (const auto& value : array)
+    {
+      if constexpr (is_array_v<std::ranges::range_value_t<U>>)
+        size += elements_size(value);
+      else
+        size += size_of(value) + 4;
+    }
+    return size;
+  }
+
+  static constexpr std::size_t apply(const T& array)
+  {
+    return 12 + 8 * array_rank_v<T> + elements_size(array);
+  }
+};
+
+template<typename T, typename Allocator>
+struct size_of_impl<md_array<T, Allocator>>
+{
+  static constexpr std::size_t apply(const md_array<T, Allocator>& array)
   {
-    std::size_t size = 20;
-    for (const auto& value : vec)
+    std::size_t size = 12 + 8 * array.dimensions.size();
+    for (const auto& value : array.values)
       size += size_of(value) + 4;
     return size;
   }
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+namespace psql
+{
+namespace detail
+{
+// Prepared statement names mapped to their queries.
+using statement_map = std::map<std::string, std::string, std::less<>>;
+} // namespace detail
+} // namespace psql
@@ -1,6 +1,13 @@
 #pragma once
 
-#include <array>
+#include <psql/enumerator.hpp>
+#include <psql/md_array.hpp>
+
+#include <cstddef>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
 #include <tuple>
 #include <vector>
 
@@ -26,23 +33,120 @@ template<typename T>
 constexpr bool is_user_defined_v = is_user_defined<T>::value;
 
 template<typename T>
-struct is_array : std::false_type
+constexpr bool is_string_like_v = std::is_convertible_v<const T&, std::string_view>;
+
+template<typename T>
+struct is_optional : std::false_type
+{
+};
+
+template<typename T>
+struct is_optional<std::optional<T>> : std::true_type
+{
+};
+
+template<typename T>
+constexpr bool is_optional_v = is_optional<T>::value;
+
+template<typename T>
+struct remove_optional
+{
+  using type = T;
+};
+
+template<typename T>
+struct remove_optional<std::optional<T>>
 {
+  using type = T;
 };
 
 template<typename T>
-struct is_array<std::vector<T>> : std::true_type
+using remove_optional_t = typename remove_optional<T>::type;
+
+// std::vector<std::byte> and std::span<const std::byte> map to bytea. Other ranges of bytes, such as std::array, stay
+// arrays of single-byte bytea elements.
+template<typename T>
+struct is_bytea : std::false_type
+{
+};
+
+template<typename Allocator>
+struct is_bytea<std::vector<std::byte, Allocator>> : std::true_type
 {
 };
 
-template<typename T, std::size_t N>
-struct is_array<std::array<T, N>> : std::true_type
+template<>
+struct is_bytea<std::span<const std::byte>> : std::true_type
+{
+};
+
+template<typename T>
+constexpr bool is_bytea_v = is_bytea<T>::value;
+
+// Any sized forward range, other than strings and bytea, maps to an array.
+template<typename T>
+struct is_array : std::false_type
+{
+};
+
+template<typename T>
+  requires(std::ranges::forward_range<T> && std::ranges::sized_range<T> &&
+           !is_string_like_v<T> && !is_bytea_v<T>)
+struct is_array<T> : std::true_type
 {
 };
 
 template<typename T>
 constexpr bool is_array_v = is_array<T>::value;
 
+template<typename T>
+struct is_md_array : std::false_type
+{
+};
+
+template<typename T, typename Allocator>
+struct is_md_array<md_array<T, Allocator>> : std::true_type
+{
+};
+
+template<typename T>
+constexpr bool is_md_array_v = is_md_array<T>::value;
+
+// Nested ranges map to multidimensional arrays.
+template<typename T>
+struct array_rank : std::integral_constant<int, 0>
+{
+};
+
+template<typename T>
+  requires(is_array_v<T>)
+struct array_rank<T> : std::integral_constant<int, 1 + array_rank<std::ranges::range_value_t<T>>::value>
+{
+};
+
+template<typename T>
+constexpr int array_rank_v = array_rank<T>::value;
+
+template<typename T>
+struct array_element
+{
+  using type = remove_optional_t<T>;
+};
+
+template<typename T>
+  requires(is_array_v<T>)
+struct array_element<T> : array_element<std::ranges::range_value_t<T>>
+{
+};
+
+template<typename T, typename Allocator>
+struct array_element<md_array<T, Allocator>> : array_element<T>
+{
+};
+
+template<typename T>
+using array_element_t = typename array_element<T>::type;
+
 template<typename>
 struct is_tuple : std::false_type
 {
@@ -56,13 +160,17 @@ struct is_tuple<std::tuple<T...>> : std::true_type
 template<typename T>
 constexpr bool is_tuple_v = is_tuple<T>::value;
 
+// User-defined enums list their enumerators instead of members.
+template<typename T>
+constexpr bool is_user_defined_enum_v = is_user_defined_v<T> && std::is_enum_v<T>;
+
 template<typename T>
 struct is_composite : std::false_type
 {
 };
 
 template<typename T>
-  requires(is_user_defined_v<T>)
+  requires(is_user_defined_v<T> && !std::is_enum_v<T>)
 struct is_composite<T> : std::true_type
 {
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string_view>
+
+namespace psql
+{
+// An enumerator of an enum mapped through `user_defined<T>::enumerators`, and its label in the server.
+template<typename T>
+struct enumerator
+{
+  T value;
+  std::string_view label;
+};
+} // namespace psql
@@ -27,6 +27,19 @@ enum class error
   unexpected_non_null_result,
   exception_in_pipeline_operation,
   user_defined_type_does_not_exist,
+  timeout_expired,
+  pq_conninfo_parse_failed,
+  not_connected,
+  unexpected_oid,
+  unexpected_member_count,
+  unexpected_array_dimensions,
+  index_out_of_range,
+  unexpected_data_size,
+  numeric_out_of_range,
+  unexpected_null,
+  unexpected_jsonb_version,
+  unexpected_enum_label,
+  infinite_value,
 };
 
 inline const boost::system::error_category& error_category()
@@ -86,6 +99,32 @@ inline const boost::system::error_category& error_category()
           return "An exception occurred while executing the pipeline operation";
         case error::user_defined_type_does_not_exist:
           return "No user-defined type with the given name was found on the server";
+        case error::timeout_expired:
+          return "The operation did not complete within the given timeout";
+        case error::pq_conninfo_parse_failed:
+          return "PQconninfoParse failed, the connection string is invalid";
+        case error::not_connected:
+          return "The connection was never established";
+        case error::unexpected_oid:
+          return "Mismatched Object Identifiers (OIDs) in received and expected types";
+        case error::unexpected_member_count:
+          return "Mismatched member counts in received and expected composite types";
+        case error::unexpected_array_dimensions:
+          return "Mismatched dimensions in received and expected arrays, or in the dimensions and values of sent ones";
+        case error::index_out_of_range:
+          return "No row or field exists at the given index";
+        case error::unexpected_data_size:
+          return "The size of the received data doesn't match its encoded lengths";
+        case error::numeric_out_of_range:
+          return "The numeric value is invalid, or is not finite or doesn't fit in psql::decimal";
+        case error::unexpected_null:
+          return "Received a NULL value for a type that isn't std::optional";
+        case error::unexpected_jsonb_version:
+          return "Unsupported jsonb format version";
+        case error::unexpected_enum_label:
+          return "The received label or the sent value has no enumerator in the mapped enum";
+        case error::infinite_value:
+          return "The received date or timestamp is infinity or -infinity";
         default:
           return "Unknown error";
       }
@@ -2,6 +2,8 @@
 
 #include <psql/detail/deserialization.hpp>
 
+#include <boost/system/result.hpp>
+
 #include <libpq-fe.h>
 
 namespace psql
@@ -53,18 +55,56 @@ public:
   }
 };
 
-template<typename T>
-T as(const field& field)
+namespace detail
 {
-  auto result = T{};
+template<typename T, typename Mode>
+boost::system::error_code deserialize(const field& field, T& value, Mode mode)
+{
+  if constexpr (is_hardened_v<Mode>)
+  {
+    const auto expected_oid = oid_of<T>();
+    if (expected_oid != 0 && expected_oid != field.oid())
+      return error::unexpected_oid;
+  }
+
+  if (field.is_null())
+  {
+    if constexpr (!is_optional_v<T>)
+    {
+      return error::unexpected_null;
+    }
+    else
+    {
+      value.reset();
+      return {};
+    }
+  }
+
+  return deserialize({ field.data(), field.size() }, value, mode);
+}
+} // namespace detail
 
-  const auto expected_oid = detail::oid_of<T>();
-  if (expected_oid != 0 && expected_oid != field.oid())
-    throw std::runtime_error{ "Mismatched Object Identifiers (OIDs) in received and expected types. Found " +
-                              std::to_string(field.oid()) + " instead of " + std::to_string(expected_oid) };
+template<typename T, detail::decode_mode Mode = hardened_t>
+boost::system::result<T> try_as(const field& field, Mode mode = Mode{})
+{
+  auto result = T{};
 
-  detail::deserialize({ field.data(), field.size() }, result);
+  if (auto ec = detail::deserialize(field, result, mode))
+    return ec;
 
   return result;
 }
+
+template<typename T, detail::decode_mode Mode = hardened_t>
+T as(const field& field, Mode mode = Mode{})
+{
+  return try_as<T>(field, mode).value();
+}
+
+// Decodes into an existing value, reusing the capacity of its strings and containers.
+template<typename T, detail::decode_mode Mode = hardened_t>
+boost::system::error_code decode_into(const field& field, T& value, Mode mode = Mode{})
+{
+  return detail::deserialize(field, value, mode);
+}
 } // namespace psql
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string_view>
+
+namespace psql
+{
+// Values of json and jsonb columns. String types hold the JSON text, which a std::string_view references in the result
+// without copying. Other types are decoded through json_traits.
+template<typename T = std::string_view>
+struct json
+{
+  T value{};
+};
+
+template<typename T = std::string_view>
+struct jsonb
+{
+  T value{};
+};
+
+// Specialize to parse json and jsonb values straight from their text in the result, e.g.:
+//
+// template<>
+// struct psql::json_traits<config>
+// {
+//   static boost::system::error_code parse(std::string_view text, config& value);
+// };
+template<typename T>
+struct json_traits;
+} // namespace psql
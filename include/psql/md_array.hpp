@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace psql
+{
+struct array_dimension
+{
+  int32_t size{};
+  int32_t lower_bound = 1;
+
+  friend bool operator==(const array_dimension&, const array_dimension&) = default;
+};
+
+// A multidimensional array stored as a flat buffer of values in row-major order, along with the size and lower bound
+// of each dimension. Nested ranges can be used instead when the lower bounds don't matter.
+template<typename T, typename Allocator = std::allocator<T>>
+struct md_array
+{
+  std::vector<array_dimension> dimensions;
+  std::vector<T, Allocator> values;
+};
+} // namespace psql
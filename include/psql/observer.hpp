@@ -0,0 +1,40 @@
+#pragma once
+
+#include <boost/system/error_code.hpp>
+
+#include <string_view>
+
+namespace psql
+{
+enum class operation
+{
+  query,
+  query_prepared,
+  prepare,
+  describe_prepared,
+  describe_portal,
+  pipeline,
+};
+
+class observer
+{
+public:
+  virtual ~observer() = default;
+
+  // Invoked after the operation is handed to libpq. `text` is the query text or the statement/portal name and
+  // `bytes_serialized` is the size of the serialized parameters.
+  virtual void on_send(operation, std::string_view /* text */, std::size_t /* bytes_serialized */)
+  {
+  }
+
+  // Invoked once, when the first response data for the operation is read from the socket.
+  virtual void on_first_byte()
+  {
+  }
+
+  // Invoked when the operation completes. `result_size` is the memory size of the received results.
+  virtual void on_complete(boost::system::error_code, std::size_t /* result_size */)
+  {
+  }
+};
+} // namespace psql
@@ -8,6 +8,9 @@
 
 #include <libpq-fe.h>
 
+#include <tuple>
+#include <vector>
+
 namespace psql
 {
 class pipeline
@@ -16,6 +19,9 @@ class pipeline
   detail::oid_map& oid_map_;
   std::string& buffer_;
   size_t index_{};
+  size_t bytes_serialized_{};
+  std::vector<std::tuple<size_t, std::string, std::string>> prepares_;
+  std::vector<std::pair<size_t, std::string>> deallocates_;
 
 public:
   pipeline(PGconn* pgconn, detail::oid_map& oid_map, std::string& buffer)
@@ -36,6 +42,7 @@ public:
     if (!PQsendQueryParams(pgconn_, query.data(), t.size(), t.data(), v.data(), l.data(), f.data(), 1))
       throw boost::system::system_error{ error::pq_send_query_params_failed };
 
+    bytes_serialized_ += buffer_.size();
     return index_++;
   }
 
@@ -47,12 +54,54 @@ public:
     if (!PQsendQueryPrepared(pgconn_, stmt_name.data(), t.size(), v.data(), l.data(), f.data(), 1))
       throw boost::system::system_error{ error::pq_send_query_prepared_failed };
 
+    bytes_serialized_ += buffer_.size();
+    return index_++;
+  }
+
+  size_t push_prepare(const std::string& stmt_name, const std::string& query)
+  {
+    if (!PQsendPrepare(pgconn_, stmt_name.data(), query.data(), 0, nullptr))
+      throw boost::system::system_error{ error::pq_send_prepare_failed };
+
+    prepares_.emplace_back(index_, stmt_name, query);
     return index_++;
   }
 
+  size_t push_deallocate(const std::string& stmt_name)
+  {
+    auto query = std::string{ "DEALLOCATE \"" };
+    for (auto c : stmt_name)
+    {
+      if (c == '"')
+        query.push_back('"');
+      query.push_back(c);
+    }
+    query.append("\";");
+
+    deallocates_.emplace_back(index_, stmt_name);
+    return push_query(query);
+  }
+
   size_t size() const noexcept
   {
     return index_;
   }
+
+  size_t bytes_serialized() const noexcept
+  {
+    return bytes_serialized_;
+  }
+
+  // The indexes, names and queries of the pushed prepare operations.
+  std::vector<std::tuple<size_t, std::string, std::string>>& prepares() noexcept
+  {
+    return prepares_;
+  }
+
+  // The indexes and names of the pushed deallocate operations.
+  std::vector<std::pair<size_t, std::string>>& deallocates() noexcept
+  {
+    return deallocates_;
+  }
 };
 } // namespace psql
@@ -3,6 +3,7 @@
 #include <psql/row.hpp>
 
 #include <memory>
+#include <vector>
 
 namespace psql
 {
@@ -153,9 +154,34 @@ inline result::const_iterator result::end() const noexcept
   return const_iterator{ pgresult_.get(), static_cast<int>(size()) };
 }
 
-template<typename... Ts>
-auto as(const result& result)
+template<typename... Ts, detail::decode_mode Mode = hardened_t>
+auto as(const result& result, Mode mode = Mode{})
 {
-  return as<Ts...>(result.at(0));
+  return as<Ts...>(result.at(0), mode);
+}
+
+template<typename... Ts, detail::decode_mode Mode = hardened_t>
+auto try_as(const result& result, Mode mode = Mode{}) -> decltype(try_as<Ts...>(result[0], mode))
+{
+  if (result.empty())
+    return error::index_out_of_range;
+
+  return try_as<Ts...>(result[0], mode);
+}
+
+// Decodes each row into an element of the vector, reusing the existing elements and their capacity. Rows are decoded
+// as `decode_into(row, value)`, so tuple elements always receive the fields of the row.
+template<typename T, typename Allocator, detail::decode_mode Mode = hardened_t>
+boost::system::error_code decode_into(const result& result, std::vector<T, Allocator>& rows, Mode mode = Mode{})
+{
+  detail::resize_array(rows, result.size());
+
+  for (size_t i = 0; i < rows.size(); i++)
+  {
+    if (auto ec = decode_into(result[i], rows[i], mode))
+      return ec;
+  }
+
+  return {};
 }
 } // namespace psql
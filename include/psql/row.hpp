@@ -61,20 +61,75 @@ public:
   }
 };
 
-template<typename T>
-auto as(const row& row)
+template<typename T, detail::decode_mode Mode = hardened_t>
+auto as(const row& row, Mode mode = Mode{})
 {
-  return as<T>(row.at(0));
+  return as<T>(row.at(0), mode);
 }
 
-template<typename T1, typename T2, typename... Ts>
-auto as(const row& row)
+template<typename T1, typename T2, typename... Ts, detail::decode_mode Mode = hardened_t>
+auto as(const row& row, Mode mode = Mode{})
 {
   return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-    return std::tuple{ as<T1>(row.at(0)), as<T2>(row.at(1)), as<Ts>(row.at(Is + 2))... };
+    return std::tuple{ as<T1>(row.at(0), mode), as<T2>(row.at(1), mode), as<Ts>(row.at(Is + 2), mode)... };
   }(std::index_sequence_for<Ts...>{});
 }
 
+template<typename T, detail::decode_mode Mode = hardened_t>
+boost::system::result<T> try_as(const row& row, Mode mode = Mode{})
+{
+  if (row.empty())
+    return error::index_out_of_range;
+
+  return try_as<T>(row[0], mode);
+}
+
+template<typename T, detail::decode_mode Mode = hardened_t>
+boost::system::error_code decode_into(const row& row, T& value, Mode mode = Mode{})
+{
+  if (row.empty())
+    return error::index_out_of_range;
+
+  return detail::deserialize(row[0], value, mode);
+}
+
+namespace detail
+{
+template<typename... Ts, decode_mode Mode>
+boost::system::error_code decode_fields(const row& row, std::tuple<Ts...>& values, Mode mode)
+{
+  if (row.size() < sizeof...(Ts))
+    return error::index_out_of_range;
+
+  auto ec = boost::system::error_code{};
+
+  [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+    (!(ec = deserialize(row[Is], std::get<Is>(values), mode)) && ...);
+  }(std::index_sequence_for<Ts...>{});
+
+  return ec;
+}
+} // namespace detail
+
+// Always decodes the fields of the row into the elements of the tuple, whatever the number of fields. A tuple is
+// decoded from a single composite field through the field overload, or as the element of a one-element tuple.
+template<typename... Ts, detail::decode_mode Mode = hardened_t>
+boost::system::error_code decode_into(const row& row, std::tuple<Ts...>& values, Mode mode = Mode{})
+{
+  return detail::decode_fields(row, values, mode);
+}
+
+template<typename T1, typename T2, typename... Ts, detail::decode_mode Mode = hardened_t>
+boost::system::result<std::tuple<T1, T2, Ts...>> try_as(const row& row, Mode mode = Mode{})
+{
+  auto result = std::tuple<T1, T2, Ts...>{};
+
+  if (auto ec = detail::decode_fields(row, result, mode))
+    return ec;
+
+  return result;
+}
+
 class row::const_iterator
 {
   const PGresult* pg_result_{};
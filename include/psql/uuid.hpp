@@ -0,0 +1,32 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace psql
+{
+struct uuid
+{
+  std::array<std::byte, 16> bytes{};
+
+  friend bool operator==(const uuid&, const uuid&) = default;
+};
+
+inline std::string to_string(const uuid& uuid)
+{
+  constexpr auto hex = std::string_view{ "0123456789abcdef" };
+
+  auto str = std::string{};
+  str.reserve(36);
+  for (size_t i = 0; i < uuid.bytes.size(); i++)
+  {
+    if (i == 4 || i == 6 || i == 8 || i == 10)
+      str.push_back('-');
+    str.push_back(hex[static_cast<unsigned char>(uuid.bytes[i]) >> 4]);
+    str.push_back(hex[static_cast<unsigned char>(uuid.bytes[i]) & 0x0F]);
+  }
+  return str;
+}
+} // namespace psql